@@ -0,0 +1,333 @@
+#include "../utils/structs.hpp"
+#include "../utils/functions.hpp"
+#include "../utils/parallel.hpp"
+#include "../utils/estado.hpp"
+#include "../utils/registro.hpp"
+#include "../utils/portfolio.hpp"
+#include "../utils/rastreio.hpp"
+#include "../utils/reordenacao.hpp"
+#include "../utils/parametros.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <omp.h>
+namespace fs = std::filesystem;
+
+// Definido em solvers.cpp (que inclui este arquivo).
+Resultado executarSolver(const std::string& algoritmo, const Instance& inst, const fs::path& caminho,
+                         const Parametros& params);
+
+// Branch-and-bound exato. Os itens são renumerados por razão lucro/peso decrescente e decididos
+// nessa ordem (profundidade d = item d). Limite de um nó com o prefixo [0, d) fixo:
+//   objetivo atual + mochila fracionária dos lucros reduzidos
+// sobre os itens restantes de lucro reduzido positivo que cabem. O lucro reduzido (lucro menos a penalidade
+// que o item dispararia agora) só diminui quando outros itens entram, pois a penalidade de um
+// conjunto é convexa na contagem; por isso é um limite válido e um item com lucro reduzido <= 0
+// é dominado (nunca entra numa solução ótima que estenda o prefixo).
+
+const int LIMITE_DEQUE_BB = 4;         // Nós doados por thread antes de explorar tudo em linha
+const int RESTANTES_MIN_DOACAO = 16;   // Subárvores menores que isso não são doadas
+const long long CUSTO_ENTRE_VERIFICACOES = 1 << 16;   // Nós x itens entre duas verificações de parada
+const long long NOS_ENTRE_VERIFICACOES = 4096;        // Teto do intervalo, para instâncias pequenas
+
+// Nó aberto: decisões dos itens [0, profundidade); os demais valem 0 em x. 'limite' é o do pai
+// (infinito na raiz), usado para fechar o nó sem recalcular se a busca parar antes de explorá-lo.
+struct NoBB {
+    int profundidade;
+    double limite;
+    std::vector<unsigned char> x;
+};
+
+// Deque de trabalho de uma thread: a dona empilha e desempilha no fim (busca em profundidade);
+// quem rouba tira do início, onde estão os nós mais rasos (as maiores subárvores).
+struct DequeTrabalho {
+    std::mutex mtx;
+    std::deque<NoBB> nos;
+
+    void empilhar(NoBB&& no) {
+        std::lock_guard<std::mutex> lock(mtx);
+        nos.push_back(std::move(no));
+    }
+
+    bool desempilhar(NoBB& no) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (nos.empty()) return false;
+        no = std::move(nos.back());
+        nos.pop_back();
+        return true;
+    }
+
+    bool roubar(NoBB& no) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (nos.empty()) return false;
+        no = std::move(nos.front());
+        nos.pop_front();
+        return true;
+    }
+
+    size_t tamanho() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return nos.size();
+    }
+};
+
+// Estado compartilhado pelas threads da busca.
+struct CompartilhadoBB {
+    std::vector<DequeTrabalho> deques;
+    std::atomic<long long> pendentes{0};    // Nós nos deques ou em exploração; 0 = busca encerrada
+    std::atomic<long long> incumbente;      // Objetivo da melhor solução (corte dos limites)
+    std::atomic<long long> nosTotais{0};
+    std::atomic<bool> parar{false};
+    std::mutex mtxMelhor;
+    std::vector<unsigned char> melhor;      // Na numeração da busca
+
+    CompartilhadoBB(int threads, long long inicial) : deques(threads), incumbente(inicial) {}
+};
+
+struct BuscaBB {
+    const Instance& inst;                   // Itens em ordem de razão decrescente
+    CompartilhadoBB& c;
+    RegistroExecucao& registro;
+    Cooperacao& cooperacao;
+    int tid;
+    long long limiteNos;
+    std::chrono::steady_clock::time_point prazo;
+    EstadoSolucao e;
+    long long nos = 0;
+    long long nosContados = 0;              // Parte de 'nos' já somada a c.nosTotais
+    long long intervaloVerificacao;         // Nós entre verificações: cada nó custa O(n log n) no limite
+    long long proximaVerificacao;
+    double limiteAberto = -1e300;           // Maior limite entre os nós abandonados por parada
+
+    // Item incluído no caminho corrente; o ramo de exclusão fica pendente se não foi doado.
+    struct Inclusao {
+        int item;
+        double limite;
+        bool doado;
+    };
+    std::vector<Inclusao> caminho;          // Pilha da busca em profundidade (sem recursão)
+
+    BuscaBB(const Instance& inst, CompartilhadoBB& c, RegistroExecucao& registro, Cooperacao& cooperacao, int tid,
+            long long limiteNos, std::chrono::steady_clock::time_point prazo)
+        : inst(inst), c(c), registro(registro), cooperacao(cooperacao), tid(tid), limiteNos(limiteNos), prazo(prazo),
+          intervaloVerificacao(std::clamp<long long>(CUSTO_ENTRE_VERIFICACOES / std::max(inst.numItems, 1), 1,
+                                                     NOS_ENTRE_VERIFICACOES)),
+          proximaVerificacao(intervaloVerificacao), reduzido(inst.numItems, 0) {}
+
+    std::vector<std::pair<double, int>> candidatos;   // (razão reduzida, item), reutilizado entre nós
+    std::vector<long long> reduzido;
+
+    long long limiteSuperior(int d) {
+        long long residual = inst.capacity - e.peso;
+        candidatos.clear();
+        for (int j = d; j < inst.numItems; ++j) {
+            long long r = inst.profits[j] - deltaPenalidadeFlip(e, inst, j);
+            if (r <= 0 || inst.weights[j] > residual) continue;   // Dominado ou não cabe
+            reduzido[j] = r;
+            candidatos.push_back({(double)r / std::max(inst.weights[j], 1), j});
+        }
+        std::sort(candidatos.begin(), candidatos.end(), std::greater<>());
+        double fracionaria = 0.0;
+        for (const auto& [razao, j] : candidatos) {
+            if (inst.weights[j] <= residual) {
+                fracionaria += reduzido[j];
+                residual -= inst.weights[j];
+            } else {
+                fracionaria += (double)reduzido[j] * residual / inst.weights[j];
+                break;
+            }
+        }
+        return e.objetivo() + static_cast<long long>(std::floor(fracionaria + 1e-9));
+    }
+
+    void publicar() {
+        std::lock_guard<std::mutex> lock(c.mtxMelhor);
+        if (e.objetivo() <= c.incumbente.load(std::memory_order_relaxed)) return;
+        c.melhor = e.x;
+        c.incumbente.store(e.objetivo(), std::memory_order_relaxed);
+        registro.melhoria(e.objetivo());
+    }
+
+    void verificarParada() {
+        c.nosTotais.fetch_add(nos - nosContados, std::memory_order_relaxed);
+        nosContados = nos;
+        proximaVerificacao = nos + intervaloVerificacao;
+        if (c.nosTotais.load(std::memory_order_relaxed) >= limiteNos || std::chrono::steady_clock::now() >= prazo ||
+            cooperacao.prazoEsgotado()) {
+            c.parar.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    // Busca em profundidade a partir do nó d, cujo pai tem limite 'limitePai'. Iterativa: a
+    // pilha 'caminho' guarda os itens incluídos, e a profundidade não depende da pilha de chamadas.
+    void explorar(int d, double limitePai) {
+        caminho.clear();
+        while (true) {
+            if (c.parar.load(std::memory_order_relaxed)) {
+                // Nó abandonado: fechado com o limite do pai, sem recalcular
+                limiteAberto = std::max<double>(limiteAberto, std::isinf(limitePai) ? limiteSuperior(d) : limitePai);
+            } else {
+                if (++nos >= proximaVerificacao) verificarParada();
+                if (e.objetivo() > c.incumbente.load(std::memory_order_relaxed)) publicar();
+                long long limite = d < inst.numItems ? limiteSuperior(d) : LLONG_MIN;
+                if (limite > c.incumbente.load(std::memory_order_relaxed)) {
+                    limitePai = limite;
+                    // Dominância: item que não cabe ou de lucro reduzido <= 0 fica de fora
+                    if (!viavelAposFlip(e, inst, d) || deltaObjetivoFlip(e, inst, d) <= 0) {
+                        ++d;
+                        continue;
+                    }
+
+                    // O ramo de exclusão é doado ao deque (e pode ser roubado) enquanto houver pouco
+                    // trabalho disponível; senão é explorado ao voltar, depois do ramo de inclusão.
+                    bool doado = false;
+                    if (inst.numItems - d > RESTANTES_MIN_DOACAO && c.deques[tid].tamanho() < LIMITE_DEQUE_BB) {
+                        c.pendentes.fetch_add(1);
+                        c.deques[tid].empilhar(NoBB{d + 1, limitePai, e.x});
+                        doado = true;
+                    }
+                    aplicarFlip(e, inst, d);
+                    caminho.push_back({d, limitePai, doado});
+                    ++d;
+                    continue;
+                }
+            }
+
+            // Volta: desfaz as inclusões até um ramo de exclusão pendente
+            bool retomado = false;
+            while (!retomado && !caminho.empty()) {
+                Inclusao volta = caminho.back();
+                caminho.pop_back();
+                aplicarFlip(e, inst, volta.item);
+                if (!volta.doado) {
+                    d = volta.item + 1;
+                    limitePai = volta.limite;
+                    retomado = true;
+                }
+            }
+            if (!retomado) return;
+        }
+    }
+};
+
+/**
+ * @brief Branch-and-bound exato e paralelo com roubo de trabalho.
+ *
+ * A incumbente inicial (e corte dos limites) vem do guloso e, opcionalmente, do LNS. Cada thread
+ * explora em profundidade a partir dos nós do próprio deque e, sem trabalho, rouba o nó mais raso
+ * de outra thread. Esgotado o limite de nós ou de tempo, os nós abertos são fechados com o limite
+ * do pai, e o resultado traz o limite superior e o gap; sem interrupção, a otimalidade é provada.
+ *
+ * @param inst A instância do problema.
+ * @param caminho Arquivo de log (uma linha por melhoria da incumbente e o resumo da busca).
+ * @param params Hiperparâmetros (os do LNS são usados na incumbente inicial).
+ * @param limite_nos Número máximo de nós (somando as threads).
+ * @param tempo_limite_seg Prazo de relógio da busca, em segundos.
+ * @param incumbente_lns Se true, roda o LNS antes da busca para obter o corte inicial.
+ * @return O melhor resultado, com otimoProvado/limiteSuperior/gap, nós e nós por segundo.
+ */
+Resultado branch_and_bound(const Instance& inst, const fs::path& caminho, const Parametros& params,
+                           long long limite_nos = 1000000000LL,
+                           double tempo_limite_seg = 60.0,
+                           bool incumbente_lns = true) {
+    RegistroExecucao registro;
+    Cooperacao cooperacao("exato");   // Em portfólio: publica melhorias e respeita o prazo
+    const int n = inst.numItems;
+
+    // Incumbente inicial, na numeração original
+    Resultado inicial = executarSolver("guloso", inst, "", params);
+    if (incumbente_lns && n > 0) {
+        Resultado lns = executarSolver("lns", inst, "", params);
+        if (lns.valorObjetivo > inicial.valorObjetivo) inicial = lns;
+    }
+    registro.contar(inicial.avaliacoes);
+
+    // Instância da busca: itens por razão lucro/peso decrescente
+    Instance ordenada = inst;
+    std::vector<int> ordem(n);
+    for (int j = 0; j < n; ++j) ordem[j] = j;
+    std::stable_sort(ordem.begin(), ordem.end(), [&](int a, int b) {
+        return (double)inst.profits[a] * std::max(inst.weights[b], 1) > (double)inst.profits[b] * std::max(inst.weights[a], 1);
+    });
+    Renumeracao renumeracao = permutarItens(ordenada, ordem);
+
+    const int threads = std::max(1, threadsDisponiveis());
+    CompartilhadoBB c(threads, inicial.valorObjetivo);
+    c.melhor.assign(n, 0);
+    for (int j = 0; j < n; ++j) c.melhor[renumeracao.novoDeOriginal[j]] = inicial.itensSelecionados[j];
+    registro.melhoria(inicial.valorObjetivo);
+
+    auto inicioBusca = std::chrono::steady_clock::now();
+    auto prazo = inicioBusca + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                   std::chrono::duration<double>(tempo_limite_seg));
+    c.pendentes = 1;
+    c.deques[0].empilhar(NoBB{0, INFINITY, std::vector<unsigned char>(n, 0)});
+
+    double limiteAberto = -1e300;
+    long long roubos = 0;
+
+    #pragma omp parallel num_threads(threads) proc_bind(close) reduction(max:limiteAberto) reduction(+:roubos)
+    {
+        EscopoRastreio regiao("exato: regiao paralela", "paralelo");
+        int tid = omp_get_thread_num();
+        BuscaBB busca(ordenada, c, registro, cooperacao, tid, limite_nos, prazo);
+        std::mt19937 rng(tid);
+        NoBB no;
+        while (true) {
+            bool obtido = c.deques[tid].desempilhar(no);
+            for (int t = 0; !obtido && t < 2 * threads; ++t) {
+                int vitima = rng() % threads;
+                if (vitima != tid && c.deques[vitima].roubar(no)) {
+                    obtido = true;
+                    roubos++;
+                }
+            }
+            if (obtido) {
+                EscopoRastreio lote("exato: subarvore", "avaliacao");
+                busca.e = criarEstado(ordenada, std::vector<bool>(no.x.begin(), no.x.end()));
+                busca.explorar(no.profundidade, no.limite);
+                c.pendentes.fetch_sub(1);
+            } else if (c.pendentes.load() == 0) {
+                break;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        registro.contar(busca.nos);
+        c.nosTotais.fetch_add(busca.nos - busca.nosContados, std::memory_order_relaxed);   // O resto não contado em verificarParada
+        limiteAberto = std::max(limiteAberto, busca.limiteAberto);
+    }
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicioBusca).count();
+
+    std::vector<bool> melhorOriginal(n, false);
+    for (int k = 0; k < n; ++k) melhorOriginal[renumeracao.originalDeNovo[k]] = c.melhor[k];
+    Resultado res = avaliarResultado(inst, melhorOriginal);
+    cooperacao.publicar(res.valorObjetivo, res.itensSelecionados);
+    registro.preencher(res);
+
+    res.otimoProvado = !c.parar.load();
+    res.limiteSuperior = res.otimoProvado ? res.valorObjetivo : std::max<double>(res.valorObjetivo, limiteAberto);
+    res.gap = res.limiteSuperior != 0 ? (res.limiteSuperior - res.valorObjetivo) / std::abs(res.limiteSuperior) : 0.0;
+    res.nos = c.nosTotais.load();
+    res.nosPorSegundo = segundos > 0 ? res.nos / segundos : 0.0;
+
+    std::ofstream log_file;
+    if (!caminho.empty()) log_file.open(caminho); // Caminho vazio = sem log
+    if (!log_file.is_open()) {
+        if (!caminho.empty()) std::cerr << "Aviso: Nao foi possivel abrir o arquivo de log para escrita: " << caminho << std::endl;
+    } else {
+        log_file << "Tempo(ms);ValorObjetivo\n";
+        for (const auto& p : res.trajetoria) log_file << p.tempoMs << ";" << p.objetivo << "\n";
+        log_file << "# Incumbente inicial;Otimo;LimiteSuperior;Gap;Nos;NosPorSegundo;Threads;Roubos\n";
+        log_file << "# " << inicial.valorObjetivo << ";" << res.otimoProvado << ";" << res.limiteSuperior << ";" << res.gap
+                 << ";" << res.nos << ";" << res.nosPorSegundo << ";" << threads << ";" << roubos << "\n";
+    }
+    return res;
+}
@@ -1,9 +1,17 @@
 #include <vector>
 #include <numeric>
+#include <algorithm>
 #include <cfloat> // Para DBL_MIN
 #include "../utils/structs.hpp"
 #include <filesystem>
 #include "../utils/functions.hpp"
+#include "../utils/parallel.hpp"
+#include "../utils/registro.hpp"
+#include "../utils/checkpoint.hpp"
+#include "../utils/portfolio.hpp"
+#include "../utils/rastreio.hpp"
+#include "../utils/lote.hpp"
+#include <random>
 #include <omp.h>  // Para OpenMP
 
 namespace fs = std::filesystem;
@@ -15,10 +23,10 @@ using namespace std;
 // o peso da mochila, retorna fitness próximo de 0.(DBL_MIN).
 
 double calculate_objective_dbl_min(const std::vector<bool>& sol,const Instance &inst  ) {
-    double total_profit = 0;
-    double total_weight = 0;
+    long long total_profit = 0;
+    long long total_weight = 0;
 
-    for (size_t j = 0; j < inst.numItems; ++j) {
+    for (int j = 0; j < inst.numItems; ++j) {
         if (sol[j]) {
             total_profit += inst.profits[j];
             total_weight += inst.weights[j];
@@ -29,31 +37,18 @@ double calculate_objective_dbl_min(const std::vector<bool>& sol,const Instance &
     if (total_weight > inst.capacity) {
         return DBL_MIN; // Solução inviável
     }
-    double total_penalty_cost = 0;
-    int total_violations = 0;
-
-    for (const auto& fs : inst.forfeitSets) {
-        int items_in_set_count = 0;
-        for (int item_id : fs.items) {
-            if (sol[item_id]) {
-                items_in_set_count++;
-            }
-        }
-        // Calcula as violações para o conjunto C_i 
-        int violations_v_i = std::max(0, items_in_set_count - fs.nA);
-        total_violations += violations_v_i;
-        total_penalty_cost += static_cast<double>(violations_v_i) * fs.forfeitCost;
-    }
-    
+    // Penalidade com a mesma regra de get_objective_value (custo por item excedente em cada C_i)
+    long long total_penalty_cost = calcularPenalidade(inst, sol);
+
     // Função Objetivo: Lucro - Penalidades 
-    return total_profit - total_penalty_cost;
+    return static_cast<double>(total_profit - total_penalty_cost);
 }
 
 
 // Função para seleção de parentes com método da roleta. (Indivíduos com maior fitness/Valor na mochila tem mais chance de serem escolhidos).
-vector<bool> roulette_wheel_selection(const vector<vector<bool>> &population, const vector<double> &fitness) {
+vector<bool> roulette_wheel_selection(const vector<vector<bool>> &population, const vector<double> &fitness, mt19937 &rng) {
     double total_fitness = accumulate(fitness.begin(), fitness.end(), 0.0);
-    double random_value = ((double)rand() / RAND_MAX) * total_fitness;
+    double random_value = uniform_real_distribution<double>(0.0, 1.0)(rng) * total_fitness;
     double cumulative_sum = 0.0;
 
     for (size_t i = 0; i < population.size(); ++i) {
@@ -73,9 +68,19 @@ Resultado genetic_algorithm(const Instance &inst,
     double mutation_rate = 0.35, // Taxa de mutação aleatória.
     double maxGenEstagnated = 0.2, // Valor % do máximo de gerações estagnadas para parar o algorítmo.
     double threshold = 0.005, // Valor de diferença % para se considerar estagnação
+    bool avaliacao_lote = true, // Avalia a população inteira em blocos bit-fatiados (utils/lote.hpp)
     bool verbose = 0) {
 
+    RegistroExecucao registro;
+    mt19937 rng(registro.semente); // Gerador da execução: mesma semente, mesma evolução
+    uniform_real_distribution<double> uniforme(0.0, 1.0);
+    Cooperacao cooperacao("genetic"); // Em portfólio: publica melhorias e recebe imigrantes de elite
+
     int n_items = inst.numItems;
+    // Modo de grande escala: limita a população a ~2^30 bits no total.
+    if (modoGrandeEscala(inst)) {
+        population_size = std::max(2, std::min<int>(population_size, (1LL << 30) / std::max(n_items, 1)));
+    }
     vector<vector<bool>> population(population_size, vector<bool>(n_items));
     vector<double> fitness(population_size, -1e9);
     Resultado melhorSol;
@@ -86,36 +91,94 @@ Resultado genetic_algorithm(const Instance &inst,
         return melhorSol;
     }
 
+    // Equipe dos laços sobre a população, limitada ao orçamento do chamador
+    const int threadsPopulacao = std::max(1, std::min(threadsDisponiveis(), population_size));
+
+    // Avaliação de uma população inteira: em lote (uma passada pela instância a cada 64-512
+    // indivíduos) ou um indivíduo por vez (paralelizado)
+    auto avaliarPopulacao = [&](const vector<vector<bool>> &pop) {
+        if (avaliacao_lote) {
+            avaliarPopulacaoFatiada(pop, inst, fitness);
+        } else {
+            #pragma omp parallel for num_threads(threadsPopulacao) if(threadsPopulacao > 1)
+            for (int i = 0; i < population_size; ++i) {
+                EscopoRastreio lote("genetic: fitness", "avaliacao");
+                fitness[i] = calculate_objective_dbl_min(pop[i], inst);
+            }
+        }
+        registro.contar(population_size);
+    };
+
     // Inicializar população com soluções zeradas ( Pode-se paralelizar ).
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(threadsPopulacao) if(threadsPopulacao > 1)
     for (int i = 0; i < population_size; ++i) {
         for (int j = 0; j < n_items; ++j) {
             population[i][j] = 0;
         }
-        fitness[i] = calculate_objective_dbl_min(population[i], inst);
     }
+    avaliarPopulacao(population);
 
-    // Abrir arquivo para escrita de resultado.
-    std::ofstream log_file(caminho);
+    // Checkpoint: população, fitness, gerador, melhor solução e contadores, gravados entre gerações
+    int ultimaGeracaoDeMelhora = -1;
+    int geracaoInicial = 0;
+    AgendaCheckpoint agenda;
+    const vector<double> parametros = {(double)population_size, (double)max_generations, crossover_rate,
+                                       mutation_rate, maxGenEstagnated, threshold};
+    if (agenda.retomando()) {
+        LeitorBinario l = carregarCheckpoint(agenda.config.retomar, "genetic", inst);
+        conferirParametros(l, parametros);
+        lerRegistro(l, registro);
+        geracaoInicial = l.valor<int>();
+        ultimaGeracaoDeMelhora = l.valor<int>();
+        l.gerador(rng);
+        l.gerador(uniforme);
+        for (auto &individual : population) individual = l.bits();
+        fitness = l.vetor<double>();
+        melhorSol.itensSelecionados = l.bits();
+        melhorSol.valorObjetivo = l.valor<long long>();
+        melhorSol.pesoTotal = l.valor<long long>();
+    }
+    auto salvarEstado = [&](int proximaGeracao) {
+        GravadorBinario g;
+        g.vetor(parametros);
+        gravarRegistro(g, registro);
+        g.valor(proximaGeracao);
+        g.valor(ultimaGeracaoDeMelhora);
+        g.gerador(rng);
+        g.gerador(uniforme);
+        for (const auto &individual : population) g.bits(individual);
+        g.vetor(fitness);
+        g.bits(melhorSol.itensSelecionados);
+        g.valor(melhorSol.valorObjetivo);
+        g.valor(melhorSol.pesoTotal);
+        try {
+            salvarCheckpoint(agenda.config.arquivo, "genetic", inst, g);
+        } catch (const std::exception& e) {
+            std::cerr << "Aviso: " << e.what() << std::endl;
+        }
+    };
+
+    // Abrir arquivo para escrita de resultado (na retomada, continua o log interrompido).
+    std::ofstream log_file;
+    if (!caminho.empty()) log_file.open(caminho, agenda.retomando() ? std::ios::app : std::ios::trunc); // Caminho vazio = sem log
     if (!log_file.is_open()) {
-        std::cerr << "Aviso: Nao foi possivel abrir o arquivo de log para escrita: " << caminho << std::endl;
-    } else {
+        if (!caminho.empty()) std::cerr << "Aviso: Nao foi possivel abrir o arquivo de log para escrita: " << caminho << std::endl;
+    } else if (!agenda.retomando()) {
         log_file << "Iteracao;ValorObjetivo;Peso\n";
     }
 
     // 2. Loop principal do algoritmo genético
-    int ultimaGeracaoDeMelhora = -1;
-    for (int generation = 0; generation < max_generations; ++generation) {
+    for (int generation = geracaoInicial; generation < max_generations; ++generation) {
         vector<vector<bool>> new_population;
 
         // 2.2 Reprodução
         while (new_population.size() < population_size) {
-            vector<bool> parent1 = roulette_wheel_selection(population, fitness);
-            vector<bool> parent2 = roulette_wheel_selection(population, fitness);
+            vector<bool> parent1 = roulette_wheel_selection(population, fitness, rng);
+            vector<bool> parent2 = roulette_wheel_selection(population, fitness, rng);
 
             // Crossover com probabilidade definida
-            if ((double)rand() / RAND_MAX < crossover_rate) {
-                int crossover_point = rand() % n_items;
+            if (uniforme(rng) < crossover_rate) {
+                int crossover_point = uniform_int_distribution<int>(0, n_items - 1)(rng);
                 vector<bool> child1 = parent1, child2 = parent2;
                 for (int i = crossover_point; i < n_items; ++i) {
                     swap(child1[i], child2[i]);
@@ -131,18 +194,21 @@ Resultado genetic_algorithm(const Instance &inst,
                 }
             }
         }
-        // 2.3 Mutação (Pode-se paralelizar)
-        #pragma omp parallel for
+        // 2.3 Mutação (sequencial: um sorteio por indivíduo, no gerador da execução)
         for (auto &individual : new_population) {
-            if ((double)rand() / RAND_MAX < mutation_rate) {
-                int mutation_point = rand() % n_items;
+            if (uniforme(rng) < mutation_rate) {
+                int mutation_point = uniform_int_distribution<int>(0, n_items - 1)(rng);
                 individual[mutation_point] = !individual[mutation_point];
             }
         }
-        // 2.41 Avaliação da nova população: Cálculo de fitness (paralelizado)
-        #pragma omp parallel for
-        for (int i = 0; i < population_size; ++i) {
-            fitness[i] = calculate_objective_dbl_min(new_population[i], inst);
+        // 2.41 Avaliação da nova população: Cálculo de fitness
+        avaliarPopulacao(new_population);
+
+        // Imigrante: a elite do portfólio, se melhor que a nossa, substitui o pior indivíduo
+        if (std::shared_ptr<const SolucaoPublicada> elite = cooperacao.importar(melhorSol.valorObjetivo)) {
+            int pior = min_element(fitness.begin(), fitness.end()) - fitness.begin();
+            new_population[pior] = elite->itens;
+            fitness[pior] = calculate_objective_dbl_min(new_population[pior], inst);
         }
 
         // 2.42 Depois do loop em paralelo, fazer a busca da melhor solução sequencialmente.
@@ -154,22 +220,25 @@ Resultado genetic_algorithm(const Instance &inst,
                 generation_best_sol = new_population[i]; // ← CORREÇÃO DO SEU BUG!
             }
         }
-        int pesoTotal = calcularPeso(inst, generation_best_sol);
+        long long pesoTotal = calcularPeso(inst, generation_best_sol);
 
         if (log_file.is_open()) {
+            EscopoRastreio io("log", "io");
             log_file << generation + 1 << ";" << generation_best_fitness << ";" << pesoTotal << "\n";
         }
         // Armazenar melhor de todas as gerações
         if (generation_best_fitness > melhorSol.valorObjetivo) {
-            int ultimaSolOtima = melhorSol.valorObjetivo;
+            long long ultimaSolOtima = melhorSol.valorObjetivo;
             melhorSol.valorObjetivo = generation_best_fitness;
             melhorSol.itensSelecionados = generation_best_sol;
             melhorSol.pesoTotal = pesoTotal;
+            registro.melhoria(melhorSol.valorObjetivo);
+            cooperacao.publicar(melhorSol.valorObjetivo, melhorSol.itensSelecionados);
             double melhoraNaFuncaoObjetivo;
             // Caso valor objetivo seja diferente de 0
             if (melhorSol.valorObjetivo != 0) {
                 // calcula uma melhora percentual do valor objetivo
-                double tmp1 =(melhorSol.valorObjetivo - ultimaSolOtima);
+                double tmp1 = static_cast<double>(melhorSol.valorObjetivo - ultimaSolOtima);
                 melhoraNaFuncaoObjetivo = tmp1 / (melhorSol.valorObjetivo);
             } else {
                 // Caso seja 0, apenas considere que o algorítimo deve continuar 
@@ -185,6 +254,7 @@ Resultado genetic_algorithm(const Instance &inst,
         if (generation - ultimaGeracaoDeMelhora > maxGenEstagnated * max_generations) {
             melhorSol.penalidadeTotal = calcularPenalidade(inst, melhorSol.itensSelecionados);
             melhorSol.lucroTotal = melhorSol.valorObjetivo + melhorSol.penalidadeTotal;
+            registro.preencher(melhorSol);
 
             if (verbose) {
                 cout << "GA interrompido em " << generation << " gerações.\n";
@@ -199,6 +269,8 @@ Resultado genetic_algorithm(const Instance &inst,
         }
 
         population = new_population;
+        if (agenda.devido()) salvarEstado(generation + 1);
+        if (cooperacao.prazoEsgotado()) break;
     }
     // Caso o algorítimo alcançe o número máximo de gerações, retorna a melhor solução.
     if (verbose) {
@@ -211,6 +283,7 @@ Resultado genetic_algorithm(const Instance &inst,
 
     melhorSol.penalidadeTotal = calcularPenalidade(inst, melhorSol.itensSelecionados);
     melhorSol.lucroTotal = melhorSol.valorObjetivo + melhorSol.penalidadeTotal;
+    registro.preencher(melhorSol);
 
     return melhorSol;
 }
@@ -0,0 +1,295 @@
+#include "../utils/interpreter.hpp"
+#include "../utils/functions.hpp"
+#include "../utils/parallel.hpp"
+#include "../utils/estado.hpp"
+#include "../utils/guloso.hpp"
+#include "../utils/registro.hpp"
+#include "../utils/portfolio.hpp"
+#include "../utils/rastreio.hpp"
+#include <algorithm>
+#include <climits>
+#include <filesystem>
+#include <numeric>
+#include <random>
+#include <omp.h>
+namespace fs = std::filesystem;
+
+// Operadores de destruição do LNS.
+enum OperadorDestruicao { DESTROI_ALEATORIO = 0, DESTROI_RELACIONADO = 1, DESTROI_PIOR_RAZAO = 2, NUM_DESTRUICOES = 3 };
+
+// Libera 'k' itens escolhidos ao acaso.
+void destruirAleatorio(const Instance& inst, int k, std::mt19937& rng, std::vector<int>& livres, std::vector<unsigned char>& marcado) {
+    std::uniform_int_distribution<int> dist(0, inst.numItems - 1);
+    while ((int)livres.size() < k) {
+        int item = dist(rng);
+        if (!marcado[item]) {
+            marcado[item] = 1;
+            livres.push_back(item);
+        }
+    }
+}
+
+// Libera 'k' itens relacionados: parte de um item sorteado e percorre (em largura)
+// os itens que compartilham conjuntos de penalidade com os já liberados.
+void destruirRelacionado(const Instance& inst, int k, std::mt19937& rng, std::vector<int>& livres, std::vector<unsigned char>& marcado) {
+    std::uniform_int_distribution<int> dist(0, inst.numItems - 1);
+    size_t frente = livres.size();
+    while ((int)livres.size() < k) {
+        if (frente == livres.size()) {
+            int semente = dist(rng);
+            if (marcado[semente]) continue;
+            marcado[semente] = 1;
+            livres.push_back(semente);
+        }
+        int item = livres[frente++];
+        for (int p = inst.inicioConjuntosItem[item]; p < inst.inicioConjuntosItem[item + 1] && (int)livres.size() < k; ++p) {
+            const auto& conjunto = inst.forfeitSets[inst.conjuntosDoItem[p]].items;
+            if (conjunto.empty()) continue;
+            // Começa em uma posição aleatória do conjunto para não favorecer os primeiros itens
+            int inicio = std::uniform_int_distribution<int>(0, (int)conjunto.size() - 1)(rng);
+            for (size_t t = 0; t < conjunto.size() && (int)livres.size() < k; ++t) {
+                int vizinho = conjunto[(inicio + t) % conjunto.size()];
+                if (!marcado[vizinho]) {
+                    marcado[vizinho] = 1;
+                    livres.push_back(vizinho);
+                }
+            }
+        }
+    }
+}
+
+// Libera metade dos itens como os selecionados de pior razão lucro/peso e a outra metade
+// como os não selecionados de melhor razão, dentre uma amostra de O(k) itens sorteados
+// (o custo não depende de n e a amostragem varia as escolhas entre iterações).
+void destruirPiorRazao(const Instance& inst, const EstadoSolucao& e, int k, std::mt19937& rng,
+                       std::vector<int>& livres, std::vector<unsigned char>& marcado, std::vector<std::pair<double, int>>& buffer) {
+    std::uniform_int_distribution<int> dist(0, inst.numItems - 1);
+    const int tamAmostra = std::min(inst.numItems, 32 * k);
+    for (int lado = 0; lado < 2; ++lado) {
+        buffer.clear();
+        for (int t = 0; t < tamAmostra; ++t) {
+            int j = tamAmostra == inst.numItems ? t : dist(rng);
+            if (marcado[j] || e.x[j] != (lado == 0)) continue;
+            double razao = (double)inst.profits[j] / std::max(inst.weights[j], 1);
+            buffer.push_back({lado == 0 ? razao : -razao, j});   // Menores primeiro
+        }
+        std::sort(buffer.begin(), buffer.end());
+        int alvo = lado == 0 ? k / 2 : k;
+        for (size_t t = 0; t < buffer.size() && (int)livres.size() < alvo; ++t) {
+            if (marcado[buffer[t].second]) continue;   // Amostra com repetição
+            marcado[buffer[t].second] = 1;
+            livres.push_back(buffer[t].second);
+        }
+    }
+    if ((int)livres.size() < k) destruirAleatorio(inst, k, rng, livres, marcado);
+}
+
+// Reparo exato: com todos os demais itens fixos, escolhe o melhor subconjunto dos itens
+// livres por branch-and-bound sobre a capacidade residual e as contagens dos conjuntos.
+// O limite superior de um nó é min(Σ lucros reduzidos positivos, mochila fracionária).
+struct ReparoExato {
+    const Instance& inst;
+    EstadoSolucao& e;
+    const std::vector<int>& livres;   // Ordenados por razão lucro/peso decrescente
+    long long limiteNos;
+    long long nos = 0;
+    long long melhorObjetivo = LLONG_MIN;
+    std::vector<unsigned char> escolha, melhorEscolha;
+
+    ReparoExato(const Instance& inst, EstadoSolucao& e, const std::vector<int>& livres, long long limiteNos)
+        : inst(inst), e(e), livres(livres), limiteNos(limiteNos), escolha(livres.size(), 0), melhorEscolha(livres.size(), 0) {}
+
+    long long limiteSuperior(size_t d) const {
+        long long residual = inst.capacity - e.peso;
+        long long somaReduzida = 0;
+        double fracionaria = 0.0;
+        for (size_t t = d; t < livres.size(); ++t) {
+            int item = livres[t];
+            long long reduzido = inst.profits[item] - deltaPenalidadeFlip(e, inst, item);
+            if (reduzido > 0) somaReduzida += reduzido;
+            if (residual > 0) {
+                if (inst.weights[item] <= residual) {
+                    fracionaria += inst.profits[item];
+                    residual -= inst.weights[item];
+                } else {
+                    fracionaria += (double)inst.profits[item] * residual / inst.weights[item];
+                    residual = 0;
+                }
+            }
+        }
+        return e.objetivo() + std::min(somaReduzida, static_cast<long long>(fracionaria));
+    }
+
+    void buscar(size_t d) {
+        if (++nos > limiteNos) return;
+        if (e.objetivo() > melhorObjetivo) {
+            melhorObjetivo = e.objetivo();
+            melhorEscolha.assign(escolha.begin(), escolha.begin() + d);
+            melhorEscolha.resize(livres.size(), 0);
+        }
+        if (d == livres.size() || limiteSuperior(d) <= melhorObjetivo) return;
+
+        int item = livres[d];
+        // Inclui o item somente se couber e tiver lucro reduzido positivo (caso contrário é dominado)
+        if (e.peso + inst.weights[item] <= inst.capacity && deltaObjetivoFlip(e, inst, item) > 0) {
+            aplicarFlip(e, inst, item);
+            escolha[d] = 1;
+            buscar(d + 1);
+            escolha[d] = 0;
+            aplicarFlip(e, inst, item);
+        }
+        buscar(d + 1);
+    }
+
+    // Resolve o subproblema e deixa 'e' com a melhor atribuição encontrada.
+    void resolver() {
+        // A atribuição original é a incumbente inicial: o reparo nunca piora a solução.
+        melhorObjetivo = e.objetivo();
+        for (size_t t = 0; t < livres.size(); ++t) {
+            melhorEscolha[t] = e.x[livres[t]];
+            if (melhorEscolha[t]) aplicarFlip(e, inst, livres[t]);
+        }
+
+        buscar(0);
+
+        for (size_t t = 0; t < livres.size(); ++t) if (melhorEscolha[t]) aplicarFlip(e, inst, livres[t]);
+    }
+};
+
+/**
+ * @brief Large Neighborhood Search com reparo exato de subproblemas pequenos.
+ * @param inst A instância do problema.
+ * @param caminho Arquivo de log (uma linha por melhoria da incumbente global).
+ * @param max_iter Número total de iterações destruir/reparar (somando todas as threads).
+ * @param k_livres Número de itens liberados a cada destruição.
+ * @param limite_nos Número máximo de nós do branch-and-bound de cada reparo.
+ * @param maxIterEstagnado Fração de max_iter sem melhora global que encerra a busca.
+ * @return Um struct Resultado com a melhor solução compartilhada entre as threads.
+ */
+Resultado lns(const Instance& inst, const fs::path& caminho,
+              int max_iter = 5000,
+              int k_livres = 16,
+              long long limite_nos = 200000,
+              double maxIterEstagnado = 0.3) {
+    if (inst.numItems == 0) return avaliarResultado(inst, std::vector<bool>());
+    RegistroExecucao registro;
+    Cooperacao cooperacao("lns");   // Só o prazo: o LNS não é membro do portfólio
+
+    k_livres = std::max(1, std::min(k_livres, inst.numItems));
+    const int limiteEstagnado = std::max(1, static_cast<int>(maxIterEstagnado * max_iter));
+
+    std::ofstream log_file;
+    if (!caminho.empty()) log_file.open(caminho); // Caminho vazio = sem log
+    if (!log_file.is_open()) {
+        if (!caminho.empty()) std::cerr << "Aviso: Nao foi possivel abrir o arquivo de log para escrita: " << caminho << std::endl;
+    } else {
+        log_file << "Iteracao;ValorObjetivo;Peso\n";
+    }
+
+    // Incumbente compartilhada entre as threads
+    // Solução inicial: construção gulosa ciente das penalidades
+    EstadoSolucao inicial = criarEstadoVazio(inst);
+    std::mt19937 rngInicial(0);
+    construirGuloso(inst, inicial, 0.0, rngInicial);
+    std::vector<bool> melhorGlobal = paraVetor(inicial);
+    long long objetivoGlobal = inicial.objetivo();
+    long long pesoGlobal = inicial.peso;
+    int ultimaMelhora = 0;
+    registro.contar(inst.numItems);
+    registro.melhoria(objetivoGlobal);
+
+    // Modelo de custo: uma iteração custa ~ O(k) deltas de destruição mais o reparo de k itens.
+    int tamAmostra = std::min(inst.numItems, 64);
+    double custoDelta = medirCustoNs([&]() {
+        long long soma = 0;
+        for (int j = 0; j < tamAmostra; ++j) soma += deltaObjetivoFlip(inicial, inst, j);
+        return soma;
+    }) / std::max(tamAmostra, 1);
+    double custoIteracao = custoDelta * 128.0 * k_livres;
+    PlanoParalelo plano = planejarParalelismo(max_iter, custoIteracao, 1);
+
+    #pragma omp parallel num_threads(plano.threads) if(plano.threads > 1) proc_bind(close)
+    {
+        EscopoRastreio regiao("lns: regiao paralela", "paralelo");
+        std::mt19937 rng(registro.semente + omp_get_thread_num());
+        EstadoSolucao atual = inicial;
+        std::vector<int> livres;
+        std::vector<unsigned char> marcado(inst.numItems, 0);
+        std::vector<std::pair<double, int>> buffer;
+
+        // Pesos adaptativos dos operadores de destruição (roleta, estilo ALNS)
+        double pesos[NUM_DESTRUICOES] = {1.0, 1.0, 1.0};
+        int semMelhoraLocal = 0;
+
+        #pragma omp for schedule(dynamic, plano.chunk) nowait
+        for (int it = 0; it < max_iter; ++it) {
+            int ultima;
+            #pragma omp atomic read
+            ultima = ultimaMelhora;
+            if (it - ultima > limiteEstagnado || cooperacao.prazoEsgotado()) continue;   // Estagnação ou prazo: esgota o laço
+            EscopoRastreio lote("lns: iteracao", "avaliacao");
+
+            // Sem progresso local por muito tempo: recomeça da incumbente compartilhada
+            if (semMelhoraLocal > 50) {
+                double espera = instanteRastreioUs();
+                #pragma omp critical(lns_incumbente)
+                {
+                    registrarIntervalo("espera critical", "sincronizacao", espera);
+                    atual = criarEstado(inst, melhorGlobal);
+                }
+                semMelhoraLocal = 0;
+            }
+
+            // 1. Destruição
+            std::discrete_distribution<int> roleta(pesos, pesos + NUM_DESTRUICOES);
+            int op = roleta(rng);
+            livres.clear();
+            if (op == DESTROI_ALEATORIO) destruirAleatorio(inst, k_livres, rng, livres, marcado);
+            else if (op == DESTROI_RELACIONADO) destruirRelacionado(inst, k_livres, rng, livres, marcado);
+            else destruirPiorRazao(inst, atual, k_livres, rng, livres, marcado, buffer);
+            for (int item : livres) marcado[item] = 0;
+
+            std::sort(livres.begin(), livres.end(), [&](int a, int b) {
+                return (double)inst.profits[a] / std::max(inst.weights[a], 1) >
+                       (double)inst.profits[b] / std::max(inst.weights[b], 1);
+            });
+
+            // 2. Reparo exato do subproblema liberado
+            long long antes = atual.objetivo();
+            ReparoExato reparo(inst, atual, livres, limite_nos);
+            reparo.resolver();
+            registro.contar(reparo.nos);
+
+            bool melhorou = atual.objetivo() > antes;
+            pesos[op] = 0.9 * pesos[op] + 0.1 * (melhorou ? 3.0 : 0.5);
+            semMelhoraLocal = melhorou ? 0 : semMelhoraLocal + 1;
+
+            // 3. Publica na incumbente compartilhada
+            long long objetivoLido;
+            #pragma omp atomic read
+            objetivoLido = objetivoGlobal;
+            if (atual.objetivo() > objetivoLido) {
+                double espera = instanteRastreioUs();
+                #pragma omp critical(lns_incumbente)
+                {
+                    registrarIntervalo("espera critical", "sincronizacao", espera);
+                    if (atual.objetivo() > objetivoGlobal) {
+                        melhorGlobal.assign(atual.x.begin(), atual.x.end());
+                        pesoGlobal = atual.peso;
+                        #pragma omp atomic write
+                        objetivoGlobal = atual.objetivo();
+                        #pragma omp atomic write
+                        ultimaMelhora = it;
+                        registro.melhoria(objetivoGlobal);
+                        EscopoRastreio io("log", "io");
+                        if (log_file.is_open()) log_file << it + 1 << ";" << objetivoGlobal << ";" << pesoGlobal << "\n";
+                    }
+                }
+            }
+        }
+    }
+
+    Resultado res = avaliarResultado(inst, melhorGlobal);
+    registro.preencher(res);
+    return res;
+}
@@ -0,0 +1,268 @@
+#include "../utils/interpreter.hpp"
+#include "../utils/functions.hpp"
+#include "../utils/parallel.hpp"
+#include "../utils/estado.hpp"
+#include "../utils/guloso.hpp"
+#include "../utils/registro.hpp"
+#include "../utils/portfolio.hpp"
+#include "../utils/rastreio.hpp"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <random>
+#include <omp.h>
+namespace fs = std::filesystem;
+
+// Réplica do recozimento: estado incremental mais as listas de itens dentro e fora da
+// mochila (sorteio O(1) dos itens de uma troca). pos[j] = posição de j na sua lista.
+// A melhor solução da réplica não é copiada a cada melhoria: guarda-se só o ponto do histórico
+// de flips em que ela ocorreu, e melhorX é reconstruída ao consolidar (custo O(1) amortizado).
+struct ReplicaTempera {
+    EstadoSolucao estado;
+    std::vector<int> dentro, fora, pos;
+    std::mt19937_64 rng;
+    long long melhorObjetivo;
+    std::vector<unsigned char> melhorX;
+    std::vector<int> historico;   // Flips desde a última consolidação
+    int passoMelhor = -1;         // Posição no histórico da melhor solução (-1 = já em melhorX)
+    long long aceitos = 0;
+};
+
+void iniciarReplica(ReplicaTempera& r, const Instance& inst) {
+    r.dentro.clear();
+    r.fora.clear();
+    r.pos.assign(inst.numItems, 0);
+    for (int j = 0; j < inst.numItems; ++j) {
+        auto& lista = r.estado.x[j] ? r.dentro : r.fora;
+        r.pos[j] = lista.size();
+        lista.push_back(j);
+    }
+    r.melhorObjetivo = r.estado.objetivo();
+    r.melhorX = r.estado.x;
+    r.historico.clear();
+    r.passoMelhor = -1;
+}
+
+// Atualiza melhorX (estado atual com os flips posteriores à melhor solução desfeitos) e
+// esvazia o histórico.
+void consolidarMelhor(ReplicaTempera& r) {
+    if (r.passoMelhor >= 0) {
+        r.melhorX = r.estado.x;
+        for (int t = (int)r.historico.size() - 1; t >= r.passoMelhor; --t) r.melhorX[r.historico[t]] ^= 1;
+        r.passoMelhor = -1;
+    }
+    r.historico.clear();
+}
+
+// Inverte j no estado e o move para a outra lista. O histórico cheio é consolidado antes do
+// flip, para que melhorX seja reconstruída só com os flips já registrados.
+void flipReplica(ReplicaTempera& r, const Instance& inst, int j) {
+    if ((int)r.historico.size() >= inst.numItems) consolidarMelhor(r);
+    auto& origem = r.estado.x[j] ? r.dentro : r.fora;
+    auto& destino = r.estado.x[j] ? r.fora : r.dentro;
+    int ultimo = origem.back();
+    origem[r.pos[j]] = ultimo;
+    r.pos[ultimo] = r.pos[j];
+    origem.pop_back();
+    r.pos[j] = destino.size();
+    destino.push_back(j);
+    aplicarFlip(r.estado, inst, j);
+    r.historico.push_back(j);
+}
+
+// Critério de Metropolis para maximização.
+bool aceitarMetropolis(long long delta, double temperatura, std::mt19937_64& rng) {
+    if (delta >= 0) return true;
+    return std::uniform_real_distribution<double>(0.0, 1.0)(rng) < std::exp(delta / temperatura);
+}
+
+/**
+ * @brief Uma varredura ('propostas' propostas) de recozimento à temperatura dada. Metade das propostas
+ *        é flip de um item sorteado; a outra metade, troca de um item de dentro por um de fora.
+ *        Só estados viáveis (peso <= capacidade) são visitados; cada proposta custa
+ *        O(conjuntos dos itens envolvidos).
+ */
+void varreduraTempera(ReplicaTempera& r, const Instance& inst, double temperatura, int propostas) {
+    std::uniform_int_distribution<int> sorteioItem(0, inst.numItems - 1);
+    for (int t = 0; t < propostas; ++t) {
+        if ((r.rng() & 1) || r.dentro.empty() || r.fora.empty()) {
+            int j = sorteioItem(r.rng);
+            if (!viavelAposFlip(r.estado, inst, j)) continue;
+            if (!aceitarMetropolis(deltaObjetivoFlip(r.estado, inst, j), temperatura, r.rng)) continue;
+            flipReplica(r, inst, j);
+        } else {
+            int sai = r.dentro[r.rng() % r.dentro.size()];
+            int entra = r.fora[r.rng() % r.fora.size()];
+            if (r.estado.peso - inst.weights[sai] + inst.weights[entra] > inst.capacity) continue;
+            if (!aceitarMetropolis(deltaObjetivoTroca(r.estado, inst, entra, sai), temperatura, r.rng)) continue;
+            flipReplica(r, inst, sai);
+            flipReplica(r, inst, entra);
+        }
+        r.aceitos++;
+        if (r.estado.objetivo() > r.melhorObjetivo) {
+            r.melhorObjetivo = r.estado.objetivo();
+            r.passoMelhor = r.historico.size();
+        }
+    }
+}
+
+/**
+ * @brief Têmpera paralela: recozimento simulado com troca de réplicas.
+ *
+ * Cada réplica roda a uma temperatura fixa de uma escala geométrica entre temp_min e temp_max
+ * (frações do lucro médio dos itens). A cada 'intervalo_troca' varreduras, pares de temperaturas
+ * vizinhas (alternando pares pares/ímpares) trocam de réplica pelo critério
+ * min(1, exp((f_j - f_i)(1/T_i - 1/T_j))); trocam-se só as temperaturas, não os estados.
+ * As réplicas são repartidas entre as threads de uma única equipe; como cada uma tem seu
+ * próprio gerador, o resultado não depende do número de threads.
+ *
+ * @param inst A instância do problema.
+ * @param caminho Arquivo de log (uma linha por rodada de trocas).
+ * @param max_varreduras Varreduras (n propostas cada; no modo de grande escala, no máximo
+ *        LIMIAR_GRANDE_ESCALA) por réplica.
+ * @param temp_min Temperatura mais fria, em frações do lucro médio.
+ * @param temp_max Temperatura mais quente, em frações do lucro médio.
+ * @param intervalo_troca Varreduras entre rodadas de troca de réplicas.
+ * @param replicas Número de réplicas (0 = uma por thread disponível, ao menos 2).
+ * @param maxEstagnado Fração das rodadas sem melhora global que encerra a busca.
+ * @return Um struct Resultado com a melhor solução encontrada por qualquer réplica.
+ */
+Resultado tempera_paralela(const Instance& inst, const fs::path& caminho,
+                           int max_varreduras = 2000,
+                           double temp_min = 0.02,
+                           double temp_max = 1.0,
+                           int intervalo_troca = 10,
+                           int replicas = 0,
+                           double maxEstagnado = 0.3) {
+    if (inst.numItems == 0) return avaliarResultado(inst, std::vector<bool>());
+    RegistroExecucao registro;
+    Cooperacao cooperacao("tempera");   // Em portfólio: publica melhorias e respeita o prazo
+
+    std::ofstream log_file;
+    if (!caminho.empty()) log_file.open(caminho); // Caminho vazio = sem log
+    if (!log_file.is_open()) {
+        if (!caminho.empty()) std::cerr << "Aviso: Nao foi possivel abrir o arquivo de log para escrita: " << caminho << std::endl;
+    } else {
+        log_file << "Rodada;ValorObjetivo;Peso\n";
+    }
+
+    const int numReplicas = std::max(2, replicas > 0 ? replicas : threadsDisponiveis());
+    intervalo_troca = std::max(1, intervalo_troca);
+    const int numRodadas = std::max(1, max_varreduras / intervalo_troca);
+    const int limiteEstagnado = std::max(1, static_cast<int>(maxEstagnado * numRodadas));
+    const int propostas = modoGrandeEscala(inst) ? std::min(inst.numItems, LIMIAR_GRANDE_ESCALA) : inst.numItems;
+
+    // Escala geométrica de temperaturas, relativa ao lucro médio dos itens
+    double lucroMedio = 0.0;
+    for (int j = 0; j < inst.numItems; ++j) lucroMedio += inst.profits[j];
+    lucroMedio = std::max(1.0, lucroMedio / inst.numItems);
+    std::vector<double> temperatura(numReplicas);
+    for (int k = 0; k < numReplicas; ++k) {
+        double f = numReplicas > 1 ? double(k) / (numReplicas - 1) : 0.0;
+        temperatura[k] = lucroMedio * temp_min * std::pow(temp_max / temp_min, f);
+    }
+
+    // Réplicas: construção gulosa aleatorizada, cada uma com gerador derivado da semente
+    std::vector<ReplicaTempera> replica(numReplicas);
+    std::vector<int> replicaNaTemperatura(numReplicas);   // Réplica que ocupa cada temperatura
+    for (int r = 0; r < numReplicas; ++r) {
+        std::seed_seq sementes{registro.semente, static_cast<unsigned>(r)};
+        replica[r].rng.seed(sementes);
+        std::mt19937 rngConstrucao(replica[r].rng());
+        replica[r].estado = criarEstadoVazio(inst);
+        construirGuloso(inst, replica[r].estado, 0.3, rngConstrucao);
+        iniciarReplica(replica[r], inst);
+        replicaNaTemperatura[r] = r;
+    }
+    registro.contar(static_cast<long long>(numReplicas) * inst.numItems);
+    std::mt19937_64 rngTrocas(registro.semente);
+
+    // Modelo de custo: uma rodada de uma réplica = intervalo_troca varreduras
+    EstadoSolucao& amostra = replica[0].estado;
+    int tamAmostra = std::min(inst.numItems, 64);
+    double custoProposta = medirCustoNs([&]() {
+        long long soma = 0;
+        for (int j = 0; j < tamAmostra; ++j) soma += deltaObjetivoFlip(amostra, inst, j);
+        return soma;
+    }) / std::max(tamAmostra, 1);
+    PlanoParalelo plano = planejarParalelismo(numReplicas, custoProposta * propostas * intervalo_troca, 2);
+
+    int melhorReplica = 0;
+    for (int r = 1; r < numReplicas; ++r) {
+        if (replica[r].melhorObjetivo > replica[melhorReplica].melhorObjetivo) melhorReplica = r;
+    }
+    std::vector<bool> melhorGlobal(replica[melhorReplica].melhorX.begin(), replica[melhorReplica].melhorX.end());
+    long long objetivoGlobal = replica[melhorReplica].melhorObjetivo;
+    registro.melhoria(objetivoGlobal);
+    cooperacao.publicar(objetivoGlobal, melhorGlobal);
+
+    long long trocasPropostas = 0, trocasAceitas = 0;
+    int semMelhora = 0;
+    bool parar = false;
+
+    // Uma única equipe para toda a execução; as rodadas são separadas pela troca em 'single'.
+    #pragma omp parallel num_threads(plano.threads) if(plano.threads > 1) proc_bind(close)
+    {
+        EscopoRastreio regiao("tempera: regiao paralela", "paralelo");
+        for (int rodada = 0; rodada < numRodadas; ++rodada) {
+            // Temperaturas de índice fixo por thread; como as trocas movem as réplicas entre
+            // temperaturas, o estado de uma réplica pode mudar de thread a cada rodada
+            #pragma omp for schedule(static)
+            for (int t = 0; t < numReplicas; ++t) {
+                int r = replicaNaTemperatura[t];
+                EscopoRastreio lote("tempera: varreduras", "avaliacao");
+                for (int v = 0; v < intervalo_troca; ++v) varreduraTempera(replica[r], inst, temperatura[t], propostas);
+                consolidarMelhor(replica[r]);
+                registro.contar(static_cast<long long>(intervalo_troca) * propostas);
+            }
+
+            #pragma omp single
+            {
+                // Troca de réplicas entre temperaturas vizinhas (pares alternados a cada rodada)
+                for (int t = rodada % 2; t + 1 < numReplicas; t += 2) {
+                    int a = replicaNaTemperatura[t], b = replicaNaTemperatura[t + 1];
+                    double expoente = double(replica[b].estado.objetivo() - replica[a].estado.objetivo()) *
+                                      (1.0 / temperatura[t] - 1.0 / temperatura[t + 1]);
+                    trocasPropostas++;
+                    if (expoente >= 0.0 || std::uniform_real_distribution<double>(0.0, 1.0)(rngTrocas) < std::exp(expoente)) {
+                        std::swap(replicaNaTemperatura[t], replicaNaTemperatura[t + 1]);
+                        trocasAceitas++;
+                    }
+                }
+
+                // Melhor global: menor índice de réplica em caso de empate
+                int melhor = -1;
+                for (int r = 0; r < numReplicas; ++r) {
+                    if (replica[r].melhorObjetivo > objetivoGlobal && (melhor == -1 || replica[r].melhorObjetivo > replica[melhor].melhorObjetivo)) melhor = r;
+                }
+                if (melhor != -1) {
+                    objetivoGlobal = replica[melhor].melhorObjetivo;
+                    melhorGlobal.assign(replica[melhor].melhorX.begin(), replica[melhor].melhorX.end());
+                    registro.melhoria(objetivoGlobal);
+                    cooperacao.publicar(objetivoGlobal, melhorGlobal);
+                    semMelhora = 0;
+                } else {
+                    semMelhora++;
+                }
+                if (log_file.is_open()) {
+                    EscopoRastreio io("log", "io");
+                    log_file << rodada + 1 << ";" << objetivoGlobal << ";" << calcularPeso(inst, melhorGlobal) << "\n";
+                }
+                parar = semMelhora >= limiteEstagnado || cooperacao.prazoEsgotado();
+            }
+            if (parar) break;
+        }
+    }
+
+    if (log_file.is_open()) {
+        log_file << "# Temperatura;Replica;MovimentosAceitos\n";
+        for (int t = 0; t < numReplicas; ++t) {
+            log_file << "# " << temperatura[t] << ";" << replicaNaTemperatura[t] << ";" << replica[replicaNaTemperatura[t]].aceitos << "\n";
+        }
+        log_file << "# Trocas aceitas: " << trocasAceitas << "/" << trocasPropostas << "\n";
+    }
+
+    Resultado res = avaliarResultado(inst, melhorGlobal);
+    registro.preencher(res);
+    return res;
+}
@@ -1,10 +1,19 @@
 #include "../utils/interpreter.hpp"
 #include "../utils/functions.hpp"
+#include "../utils/parallel.hpp"
+#include "../utils/estado.hpp"
+#include "../utils/vizinhanca.hpp"
+#include "../utils/movimentos.hpp"
+#include "../utils/rastreio.hpp"
+#include "../utils/registro.hpp"
+#include "../utils/checkpoint.hpp"
+#include "../utils/portfolio.hpp"
 #include <iostream>
 #include <filesystem>
 #include <vector>
 #include <chrono>
 #include <cfloat>
+#include <climits>
 #include <algorithm>
 #include <omp.h>
 namespace fs = std::filesystem;
@@ -17,142 +26,205 @@ namespace fs = std::filesystem;
  * @param inst A instância do problema contendo itens, conjuntos e capacidade.
  * @param max_iter O número máximo de iterações que o algoritmo executará.
  * @param tabu_tenure A duração (em iterações) que um movimento permanecerá na lista tabu.
+ * @param movimentos_compostos Avalia também, a cada iteração, trocas em conjuntos violados, cadeias
+ *        de ejeção e remoção do pior contribuinte (utils/movimentos.hpp); o melhor movimento vence.
  * @return Um struct Resultado contendo a melhor solução encontrada e suas métricas.
  */
-Resultado tabu_search(const Instance& inst, const fs::path& caminho, int max_iter=1000, int tabu_tenure=7) {
+Resultado tabu_search(const Instance& inst, const fs::path& caminho, int max_iter=1000, int tabu_tenure=7,
+                      bool movimentos_compostos=true) {
 
     // 1. Inicialização
-    std::vector<bool> current_sol(inst.numItems, false);
-    std::vector<bool> best_sol = current_sol;
+    RegistroExecucao registro;
+    // A solução corrente é mantida em um estado incremental: cada vizinho 1-flip é avaliado
+    // em O(conjuntos do item), sem copiar a solução. Memória total O(n + Σ|conjunto|).
+    EstadoSolucao current = criarEstadoVazio(inst);
+    std::vector<bool> best_sol = paraVetor(current);
     std::vector<int> tabu_list(inst.numItems, 0);
 
-    double best_obj_value = get_objective_value(best_sol, inst);
-    double current_obj_value = best_obj_value;
+    long long best_obj_value = current.objetivo();
+    long long best_peso = current.peso;
+    registro.melhoria(best_obj_value);
     
     int iters_without_improvement = 0;
     const int stopping_threshold = static_cast<int>(max_iter * 0.2);
 
+    // Em portfólio: publica melhorias e, estagnada, recomeça da elite compartilhada
+    Cooperacao cooperacao("tabu");
+
+    // Checkpoint: estado corrente, lista tabu, incumbente e contadores, gravados entre iterações
+    AgendaCheckpoint agenda;
+    const std::vector<double> parametros = {(double)max_iter, (double)tabu_tenure, (double)movimentos_compostos};
+    int iter_inicial = 0;
+    if (agenda.retomando()) {
+        LeitorBinario l = carregarCheckpoint(agenda.config.retomar, "tabu", inst);
+        conferirParametros(l, parametros);
+        lerRegistro(l, registro);
+        iter_inicial = l.valor<int>();
+        current = lerEstado(l, inst);
+        tabu_list = l.vetor<int>();
+        best_sol = l.bits();
+        best_obj_value = l.valor<long long>();
+        best_peso = l.valor<long long>();
+        iters_without_improvement = l.valor<int>();
+    }
+    auto salvar_checkpoint = [&](int proxima_iter) {
+        GravadorBinario g;
+        g.vetor(parametros);
+        gravarRegistro(g, registro);
+        g.valor(proxima_iter);
+        gravarEstado(g, current);
+        g.vetor(tabu_list);
+        g.bits(best_sol);
+        g.valor(best_obj_value);
+        g.valor(best_peso);
+        g.valor(iters_without_improvement);
+        try {
+            salvarCheckpoint(agenda.config.arquivo, "tabu", inst, g);
+        } catch (const std::exception& e) {
+            std::cerr << "Aviso: " << e.what() << std::endl;
+        }
+    };
+
     // <<< ALTERAÇÃO 1: O arquivo de log é aberto UMA VEZ, ANTES do loop.
-    std::ofstream log_file(caminho);
+    // Na retomada, o log da execução interrompida é continuado.
+    std::ofstream log_file;
+    if (!caminho.empty()) log_file.open(caminho, agenda.retomando() ? std::ios::app : std::ios::trunc); // Caminho vazio = sem log
     if (!log_file.is_open()) {
-        std::cerr << "Aviso: Nao foi possivel abrir o arquivo de log para escrita: " << caminho << std::endl;
-    } else {
+        if (!caminho.empty()) std::cerr << "Aviso: Nao foi possivel abrir o arquivo de log para escrita: " << caminho << std::endl;
+    } else if (!agenda.retomando()) {
         log_file << "Iteracao;ValorObjetivo;Peso\n";
     }
 
 
     
+    // Kernel vetorizado: avalia todos os vizinhos 1-flip em O(n + Σ|conjunto|) por iteração.
+    KernelVizinhanca kernel(inst);
+
+    // Modelo de custo: custo por item de uma passada completa do kernel.
+    double custoAvaliacao = medirCustoNs([&]() { return melhorFlip(kernel, inst, current).delta; }) / std::max(inst.numItems, 1);
+    PlanoParalelo plano = planejarParalelismo(inst.numItems, custoAvaliacao, 3);
+    const int numBlocos = plano.threads;
+    const int tamBloco = (inst.numItems + numBlocos - 1) / numBlocos;
+
+    MelhorMovimento best;
+    CandidatosMovimento candidatos;
+    bool parar = false;
+
     // 2. Loop Principal da Busca Tabu
-    for (int iter = 0; iter < max_iter; ++iter) {
-        // --- PARALELIZAÇÃO COM OPENMP ---
-        int best_move = -1;
-        double best_neighbor_obj = -DBL_MAX;
-
-        #pragma omp parallel
-        {
-            int local_best_move = -1;
-            double local_best_obj = -DBL_MAX;
-
-            // O laço 'for' é dividido entre as threads
-            #pragma omp for nowait
-            for (int j = 0; j < inst.numItems; ++j) {
-                std::vector<bool> neighbor_sol = current_sol;
-                neighbor_sol[j] = !neighbor_sol[j];
-                double neighbor_obj = get_objective_value(neighbor_sol, inst);
-                if (neighbor_obj == -DBL_MAX) continue;
-
-                if (iter >= tabu_list[j]) { // Não é tabu
-                    if (neighbor_obj > local_best_obj) {
-                        local_best_obj = neighbor_obj;
-                        local_best_move = j;
-                    }
-                } else { // É tabu -> Critério de Aspiração
-                    if (neighbor_obj > best_obj_value) {
-                        // Se um movimento aspirado for encontrado, ele tem alta prioridade
-                        #pragma omp critical
-                        {
-                            if (neighbor_obj > best_neighbor_obj) {
-                                best_neighbor_obj = neighbor_obj;
-                                best_move = j;
-                            }
-                        }
+    // Uma única equipe de threads para toda a busca; as partes seriais ficam em 'single'.
+    #pragma omp parallel num_threads(plano.threads) if(plano.threads > 1) proc_bind(close)
+    {
+        EscopoRastreio regiao("tabu: regiao paralela", "paralelo");
+        CandidatosMovimento candidatos_locais;
+        for (int iter = iter_inicial; iter < max_iter; ++iter) {
+            #pragma omp single
+            {
+                best = MelhorMovimento();
+                candidatos.entrada.clear();
+                candidatos.ejecao.clear();
+                prepararConjuntos(kernel, current);
+            }
+
+            MelhorMovimento local_best;
+            candidatos_locais.entrada.clear();
+            candidatos_locais.ejecao.clear();
+
+            // Os blocos de itens são divididos entre as threads. Só são admitidos movimentos
+            // viáveis e não tabu, ou tabu que satisfazem o critério de aspiração.
+            #pragma omp for schedule(static) nowait
+            for (int b = 0; b < numBlocos; ++b) {
+                int inicio = b * tamBloco, fim = std::min(inst.numItems, inicio + tamBloco);
+                if (inicio < fim) {
+                    EscopoRastreio lote("tabu: avaliarFaixa", "avaliacao");
+                    combinarMovimento(local_best, avaliarFaixa(kernel, inst, current, inicio, fim,
+                                                               tabu_list.data(), iter, best_obj_value));
+                    // Candidatos dos movimentos compostos a partir das penalidades que o kernel acabou de calcular
+                    if (movimentos_compostos) {
+                        coletarCandidatos(inst, current, inicio, fim, [&](int j) { return kernel.penalidadeFlip(j); },
+                                          candidatos_locais);
                     }
                 }
             }
 
-            // Cada thread compara seu melhor resultado com o melhor global (entre as threads)
+            // Cada thread compara seu melhor resultado com o melhor global (entre as threads);
+            // empates resolvidos pelo menor índice, como na execução serial
+            double espera = instanteRastreioUs();
             #pragma omp critical
             {
-                if (local_best_obj > best_neighbor_obj) {
-                    best_neighbor_obj = local_best_obj;
-                    best_move = local_best_move;
-                }
-            }
-        }
-
-        // 4. Atualiza a solução
-        if (best_move != -1) {
-            current_obj_value = best_neighbor_obj;
-            current_sol[best_move] = !current_sol[best_move];
-            tabu_list[best_move] = iter + tabu_tenure;
-
-            if (current_obj_value > best_obj_value) {
-                best_sol = current_sol;
-                best_obj_value = best_neighbor_obj;
-                iters_without_improvement = 0;
-            } else {
-                iters_without_improvement++;
+                registrarIntervalo("espera critical", "sincronizacao", espera);
+                combinarMovimento(best, local_best);
+                combinarCandidatos(candidatos, candidatos_locais);
             }
-        } else {
-            iters_without_improvement++;
-        }
-        int peso = 0;
-        for (int k = 0; k < inst.numItems; ++k) {
-            if (best_sol[k]){
-                peso += inst.weights[k];
+            {
+                EscopoRastreio barreira("barreira", "sincronizacao");
+                #pragma omp barrier
             }
-        }
-        if (log_file.is_open()) {
-            log_file << iter + 1 << ";"  << best_obj_value << ";" << peso <<"\n";
-        }
 
-        if (iters_without_improvement >= stopping_threshold) {
-            break;
-        }
-    }
-
-    // 5. Finaliza e Prepara o Resultado
+            #pragma omp single
+            {
+                EscopoRastreio serial("tabu: atualizacao", "serial");
+                // 4. Atualiza a solução
+                registro.contar(inst.numItems);   // Uma passada do kernel avalia todos os flips
+
+                // Movimentos compostos sobre os candidatos já reunidos (custo limitado por LIMITE_ENTRADA
+                // e LIMITE_VIOLADOS, não por n). Tabu se algum item do movimento for tabu, salvo pelo
+                // mesmo critério de aspiração.
+                MovimentoComposto composto;
+                if (movimentos_compostos) {
+                    composto = melhorMovimentoComposto(inst, current, candidatos);
+                    bool admissivel = composto.valido() && current.objetivo() + composto.delta > best_obj_value;
+                    if (composto.valido() && !admissivel) {
+                        admissivel = true;
+                        for (int t = 0; t < composto.numItens; ++t) admissivel &= iter >= tabu_list[composto.itens[t]];
+                    }
+                    if (!admissivel) composto = MovimentoComposto();
+                }
 
-    Resultado resultado;
-    resultado.itensSelecionados = best_sol;
+                bool moveu = true;
+                if (composto.valido() && (best.item == -1 || composto.delta > best.delta)) {
+                    aplicarMovimento(current, inst, composto);
+                    for (int t = 0; t < composto.numItens; ++t) tabu_list[composto.itens[t]] = iter + tabu_tenure;
+                } else if (best.item != -1) {
+                    aplicarFlip(current, inst, best.item);
+                    tabu_list[best.item] = iter + tabu_tenure;
+                } else {
+                    moveu = false;
+                }
 
+                if (moveu && current.objetivo() > best_obj_value) {
+                    best_sol.assign(current.x.begin(), current.x.end());
+                    best_obj_value = current.objetivo();
+                    best_peso = current.peso;
+                    registro.melhoria(best_obj_value);
+                    cooperacao.publicar(best_obj_value, best_sol);
+                    iters_without_improvement = 0;
+                } else {
+                    iters_without_improvement++;
+                }
+                if (log_file.is_open()) {
+                    EscopoRastreio io("log", "io");
+                    log_file << iter + 1 << ";"  << best_obj_value << ";" << best_peso <<"\n";
+                }
 
-    // Calcula as métricas finais da melhor solução para preencher o struct Resultado
-    int final_lucro = 0;
-    int final_peso = 0;
-    for (int j = 0; j < inst.numItems; ++j) {
-        if (best_sol[j]) {
-            final_lucro += inst.profits[j];
-            final_peso += inst.weights[j];
-        }
-    }
+                if (iters_without_improvement >= stopping_threshold / 2) {
+                    if (std::shared_ptr<const SolucaoPublicada> elite = cooperacao.importar(best_obj_value)) {
+                        current = criarEstado(inst, elite->itens);
+                        best_sol = elite->itens;
+                        best_obj_value = elite->objetivo;
+                        best_peso = current.peso;
+                        iters_without_improvement = 0;
+                    }
+                }
 
-    int final_penalidade = 0;
-    for (const auto& fs : inst.forfeitSets) {
-        int contagem_no_conjunto = 0;
-        for (int item_id : fs.items) {
-            if (best_sol[item_id]) {
-                contagem_no_conjunto++;
+                parar = iters_without_improvement >= stopping_threshold || cooperacao.prazoEsgotado();
+                if (!parar && agenda.devido()) salvar_checkpoint(iter + 1);
             }
+            if (parar) break;
         }
-        int violacoes = std::max(0, contagem_no_conjunto - fs.nA);
-        final_penalidade += violacoes * fs.forfeitCost;
     }
-    
-    resultado.lucroTotal = final_lucro;
-    resultado.pesoTotal = final_peso;
-    resultado.penalidadeTotal = final_penalidade;
-    resultado.valorObjetivo = final_lucro - final_penalidade;
 
-    return resultado;
+    // 5. Finaliza e Prepara o Resultado
+    Resultado res = avaliarResultado(inst, best_sol);
+    registro.preencher(res);
+    return res;
 }
\ No newline at end of file
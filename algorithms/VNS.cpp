@@ -10,83 +10,96 @@
 
 #include "../utils/structs.hpp"
 #include "../utils/functions.hpp" 
+#include "../utils/parallel.hpp"
+#include "../utils/estado.hpp"
+#include "../utils/vizinhanca.hpp"
+#include "../utils/movimentos.hpp"
+#include "../utils/registro.hpp"
+#include "../utils/checkpoint.hpp"
+#include "../utils/portfolio.hpp"
+#include "../utils/rastreio.hpp"
 
 namespace fs = std::filesystem;
 using namespace std;
 
-// --- Thread-local Random Number Generator (for OpenMP) ---
-// Each thread gets its own generator instance to ensure independent sequences.
-thread_local std::mt19937_64 generator;
-
-// Function to initialize RNG for each thread (call once per thread, e.g., at thread start)
-void init_thread_rng() {
-    // A simple way to get unique seeds per thread: based on current time + thread ID
-    std::random_device rd;
-    generator.seed(rd() + omp_get_thread_num());
-}
+// --- Random Number Generation ---
 
 // Function to get a random integer in a range (inclusive)
-int get_random_int(int min_val, int max_val) {
+int get_random_int(int min_val, int max_val, std::mt19937_64& generator) {
     std::uniform_int_distribution<int> distribution(min_val, max_val);
     return distribution(generator);
 }
 
 // --- Helper Functions ---
 
-// Shaking - Generates a new solution from the current one by applying 'k' random bit inversions
-vector<bool> shake_solution(const vector<bool>& sol, int n_items, int k) {
-    vector<bool> shaken_sol = sol;
+// Objective of an incremental state, -DBL_MAX when the capacity is exceeded (as get_objective_value)
+double state_objective(const EstadoSolucao& state, const Instance& inst) {
+    return state.peso > inst.capacity ? -DBL_MAX : static_cast<double>(state.objetivo());
+}
+
+// Shaking - Overwrites 'shaken' with 'sol' plus 'k' random bit inversions.
+// Reuses the buffers of 'shaken', so no memory is allocated per shake.
+void shake_solution(const EstadoSolucao& sol, EstadoSolucao& shaken, const Instance& inst, int k,
+                    std::mt19937_64& generator) {
+    shaken = sol;
     for (int i = 0; i < k; ++i) {
-        int random_bit_index = get_random_int(0, n_items - 1); // Using thread-safe RNG
-        shaken_sol[random_bit_index] = !shaken_sol[random_bit_index];
+        int random_bit_index = get_random_int(0, inst.numItems - 1, generator);
+        aplicarFlip(shaken, inst, random_bit_index);
     }
-    return shaken_sol;
 }
 
-// --- Local Search (Best Improvement 1-Opt Local Search) ---
-// Evaluates all 1-Opt neighbors and returns the best one found.
-vector<bool> local_search(const vector<bool>& current_sol, const Instance& inst) {
-    vector<bool> best_local_sol = current_sol;
-    double best_local_obj_value = get_objective_value(current_sol, inst);
-    int n_items = current_sol.size();
-
-    // Variables for each thread to find its local best
-    double thread_best_obj_value;
-    vector<bool> thread_best_sol;
-
-    // Parallelize the loop that evaluates neighbors
-    #pragma omp parallel private(thread_best_obj_value, thread_best_sol)
-    {
-        init_thread_rng(); // Initialize RNG for this thread within the parallel region
+// Compound shaking - Overwrites 'shaken' with 'sol' plus one random forfeit-set move of 'type'
+// (set swap, ejection chain or worst-contributor drop; see utils/movimentos.hpp).
+// 'shaken' is left equal to 'sol' when the neighborhood is empty (e.g. no violated set).
+void shake_compound(const EstadoSolucao& sol, EstadoSolucao& shaken, const Instance& inst, int type,
+                    CandidatosMovimento& candidates, std::mt19937_64& generator) {
+    shaken = sol;
+    prepararCandidatos(inst, shaken, candidates);
+    MovimentoComposto move = movimentoAleatorio(type, inst, shaken, candidates, generator);
+    if (move.valido()) aplicarMovimento(shaken, inst, move);
+}
 
-        // Initialize with a sufficiently small negative value for maximization
-        thread_best_obj_value = -1e+9;
-        thread_best_sol = current_sol; // Each thread starts with the current solution as its local best
+// --- Local Search (Best Improvement 1-Opt Local Search) ---
+// Evaluates all 1-Opt neighbors of 'current' in one pass of the vectorized delta kernel
+// and returns the best feasible flip in 'best_local' (item -1 if none is feasible).
+// Must be called by every thread of the enclosing team (orphaned worksharing); the item
+// range is split in 'num_blocks' blocks and 'best_local' must be shared. Outside a
+// parallel region it simply runs serially.
+void local_search(const EstadoSolucao& current, const Instance& inst, KernelVizinhanca& kernel,
+                  MelhorMovimento& best_local, int num_blocks = 1) {
+    int n_items = inst.numItems;
+    int block = (n_items + num_blocks - 1) / num_blocks;
 
-        #pragma omp for nowait // Distribute loop iterations; threads don't wait at the end of the loop
-        for (int i = 0; i < n_items; ++i) {
-            vector<bool> neighbor_sol = current_sol; // Start with the current solution for each neighbor
-            neighbor_sol[i] = !neighbor_sol[i];      // Invert one bit to get a neighbor
+    #pragma omp single
+    {
+        best_local = MelhorMovimento();
+        prepararConjuntos(kernel, current);
+    }
 
-            double neighbor_obj_value = get_objective_value(neighbor_sol, inst);
+    // Each thread finds the best neighbor within its assigned blocks
+    MelhorMovimento thread_best;
 
-            // Each thread finds the best neighbor within its assigned partition
-            if (neighbor_obj_value > thread_best_obj_value) { // Assuming maximization
-                thread_best_obj_value = neighbor_obj_value;
-                thread_best_sol = neighbor_sol;
-            }
+    #pragma omp for schedule(static) nowait // Threads don't wait at the end of the loop
+    for (int b = 0; b < num_blocks; ++b) {
+        int begin = b * block, end = std::min(n_items, begin + block);
+        if (begin < end) {
+            EscopoRastreio batch("vns: avaliarFaixa", "avaliacao");
+            combinarMovimento(thread_best, avaliarFaixa(kernel, inst, current, begin, end,
+                                                         kernel.semTabu.data(), 0, LLONG_MAX));
         }
+    }
 
-        // Combine the best results from all threads into the global best for this local search
-        #pragma omp critical // Only one thread can execute this block at a time
-        {
-            if (thread_best_obj_value > best_local_obj_value) { // Assuming maximization
-                best_local_obj_value = thread_best_obj_value;
-                best_local_sol = thread_best_sol;
-            }
-        }
+    // Combine the best results from all threads (ties go to the lowest index, as in the serial scan)
+    double wait_start = instanteRastreioUs();
+    #pragma omp critical // Only one thread can execute this block at a time
+    {
+        registrarIntervalo("espera critical", "sincronizacao", wait_start);
+        combinarMovimento(best_local, thread_best);
+    }
+    {
+        EscopoRastreio barrier("barreira", "sincronizacao");
+        #pragma omp barrier
     }
-    return best_local_sol;
 }
 
 
@@ -94,28 +107,82 @@ Resultado vns(const Instance &inst, const fs::path &caminho,
               int max_generations = 3000,
               double maxGenEstagnated_ratio = 0.3,
               double threshold = 0.01,
-              int k_max = 10, bool verbose = 0) {
+              int k_max = 10,
+              bool compound_moves = true, // Neighborhoods k_max+1.. k_max+3: forfeit-set compound moves
+              bool verbose = 0) {
+    RegistroExecucao registro;
+    // Shaking always runs inside 'single', so one generator seeded from the run seed
+    // makes the search reproducible whatever thread executes it.
+    std::mt19937_64 generator(registro.semente);
+
     int n_items = inst.numItems;
     Resultado melhorSol;
     // For maximization, initialize with a sufficiently small negative value.
     melhorSol.valorObjetivo = -1e+9;
 
     // Start with a solution where no items are selected.
-    vector<bool> current_sol(n_items, false);
+    // Solutions are kept as incremental states: memory is O(n + sum of set sizes).
+    EstadoSolucao current_sol = criarEstadoVazio(inst);
 
-    double current_obj_value = get_objective_value(current_sol, inst);
+    double current_obj_value = state_objective(current_sol, inst);
 
     // Initialize the global best solution
     if (current_obj_value > melhorSol.valorObjetivo) {
         melhorSol.valorObjetivo = current_obj_value;
-        melhorSol.itensSelecionados = current_sol;
-        melhorSol.pesoTotal = calcularPeso(inst, current_sol);
+        melhorSol.itensSelecionados = paraVetor(current_sol);
+        melhorSol.pesoTotal = current_sol.peso;
+        registro.melhoria(current_sol.objetivo());
+    }
+
+    int last_improvement_generation = -1; // Tracks the generation of the last significant improvement
+    int max_stagnated_iterations = static_cast<int>(maxGenEstagnated_ratio * max_generations);
+
+    // In a portfolio: publish improvements and restart from the shared best when it is better
+    Cooperacao cooperation("vns");
+
+    // Checkpoint: current and best solutions, shake generator and counters, saved between generations
+    AgendaCheckpoint schedule;
+    const std::vector<double> parameters = {(double)max_generations, maxGenEstagnated_ratio, threshold, (double)k_max,
+                                            (double)compound_moves};
+    int start_generation = 0;
+    if (schedule.retomando()) {
+        LeitorBinario in = carregarCheckpoint(schedule.config.retomar, "vns", inst);
+        conferirParametros(in, parameters);
+        lerRegistro(in, registro);
+        start_generation = in.valor<int>();
+        last_improvement_generation = in.valor<int>();
+        in.gerador(generator);
+        current_sol = lerEstado(in, inst);
+        current_obj_value = in.valor<double>();
+        melhorSol.itensSelecionados = in.bits();
+        melhorSol.valorObjetivo = in.valor<long long>();
+        melhorSol.pesoTotal = in.valor<long long>();
     }
+    auto save_checkpoint = [&](int next_generation) {
+        GravadorBinario out;
+        out.vetor(parameters);
+        gravarRegistro(out, registro);
+        out.valor(next_generation);
+        out.valor(last_improvement_generation);
+        out.gerador(generator);
+        gravarEstado(out, current_sol);
+        out.valor(current_obj_value);
+        out.bits(melhorSol.itensSelecionados);
+        out.valor(melhorSol.valorObjetivo);
+        out.valor(melhorSol.pesoTotal);
+        try {
+            salvarCheckpoint(schedule.config.arquivo, "vns", inst, out);
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: " << e.what() << std::endl;
+        }
+    };
 
-    std::ofstream log_file(caminho);
+    // A resumed run appends to the log of the interrupted one
+    std::ofstream log_file;
+    if (!caminho.empty()) log_file.open(caminho, schedule.retomando() ? std::ios::app : std::ios::trunc); // Empty path = no log
     if (!log_file.is_open()) {
-        std::cerr << "Warning: Could not open log file for writing: " << caminho << std::endl;
-    } else {
+        if (!caminho.empty()) std::cerr << "Warning: Could not open log file for writing: " << caminho << std::endl;
+    } else if (!schedule.retomando()) {
         log_file << "Iteration;ObjectiveValue;Weight\n";
     }
 
@@ -123,70 +190,110 @@ Resultado vns(const Instance &inst, const fs::path &caminho,
         cout << "VNS Started. Initial Solution Objective: " << current_obj_value << endl;
     }
 
-    int last_improvement_generation = -1; // Tracks the generation of the last significant improvement
-    int max_stagnated_iterations = static_cast<int>(maxGenEstagnated_ratio * max_generations);
-
-    // Seed the main thread's RNG (for shake_solution, which is called sequentially)
-    std::random_device rd;
-    generator.seed(rd());
-
-    for (int generation = 0; generation < max_generations; ++generation) {
-        int k = 1; // Start with the closest neighborhood
-        while (k <= k_max) {
-            // 1. Shaking: Generate a random neighbor in the k-th neighborhood
-            vector<bool> shaken_sol = shake_solution(current_sol, n_items, k);
-
-            // 2. Local Search: Apply local search on the shaken solution
-            // This now uses the Best Improvement logic (no RCL)
-            vector<bool> improved_sol = local_search(shaken_sol, inst);
-            double improved_obj_value = get_objective_value(improved_sol, inst);
-
-            // 3. Move or Not: Update the current and global best solution
-            if (improved_obj_value > current_obj_value) {
-                current_sol = improved_sol;
-                current_obj_value = improved_obj_value;
-                k = 1; // Reset to the closest neighborhood after an improvement
-
-                // Update the global best solution if necessary
-                if (current_obj_value > melhorSol.valorObjetivo) {
-                    double old_best_objective = melhorSol.valorObjetivo;
-                    melhorSol.valorObjetivo = current_obj_value;
-                    melhorSol.itensSelecionados = current_sol;
-                    melhorSol.pesoTotal = calcularPeso(inst, current_sol);
-
-                    double improvement_ratio;
-                    // Avoid division by zero or very small numbers when calculating relative improvement
-                    if (abs(melhorSol.valorObjetivo) > 1e-9) {
-                        improvement_ratio = (melhorSol.valorObjetivo - old_best_objective) / melhorSol.valorObjetivo;
-                    } else {
-                        // If objective is zero or very small, any positive increase can be significant
-                        improvement_ratio = (melhorSol.valorObjetivo > old_best_objective) ? (threshold * 1.1) : 0.0;
-                    }
+    // Cost model: per-item cost of one full pass of the delta kernel.
+    KernelVizinhanca kernel(inst);
+    double eval_cost = medirCustoNs([&]() { return melhorFlip(kernel, inst, current_sol).delta; }) / std::max(n_items, 1);
+    PlanoParalelo plano = planejarParalelismo(n_items, eval_cost, 3);
+
+    EstadoSolucao shaken_sol = current_sol;
+    CandidatosMovimento candidates;
+    const int k_total = k_max + (compound_moves ? NUM_TIPOS_MOVIMENTO : 0);
+    MelhorMovimento best_flip;
+    bool improved = false;
+    bool stop = false;
+
+    // A single team for the whole search: shaking and acceptance run in 'single',
+    // the neighborhood scan of local_search is shared among the threads.
+    #pragma omp parallel num_threads(plano.threads) if(plano.threads > 1) proc_bind(close)
+    {
+        EscopoRastreio region("vns: regiao paralela", "paralelo");
+        for (int generation = start_generation; generation < max_generations; ++generation) {
+            int k = 1; // Start with the closest neighborhood
+            while (k <= k_total) {
+                // 1. Shaking: Generate a random neighbor in the k-th neighborhood
+                // (k random flips up to k_max, then one compound move per extra neighborhood)
+                #pragma omp single
+                {
+                    if (k <= k_max) shake_solution(current_sol, shaken_sol, inst, k, generator);
+                    else shake_compound(current_sol, shaken_sol, inst, k - k_max - 1, candidates, generator);
+                }
 
-                    if (improvement_ratio > threshold) {
-                        last_improvement_generation = generation; // Reset stagnation counter
+                // 2. Local Search: Apply local search on the shaken solution
+                // This now uses the Best Improvement logic (no RCL)
+                local_search(shaken_sol, inst, kernel, best_flip, plano.threads);
+
+                // 3. Move or Not: Update the current and global best solution
+                #pragma omp single
+                {
+                    registro.contar(n_items); // One kernel pass evaluates every flip
+                    // The best flip is only taken if it beats the shaken solution itself
+                    double shaken_obj_value = state_objective(shaken_sol, inst);
+                    double flip_obj_value = best_flip.item != -1 ? static_cast<double>(shaken_sol.objetivo() + best_flip.delta) : -DBL_MAX;
+                    int improving_move = flip_obj_value > shaken_obj_value ? best_flip.item : -1;
+                    double improved_obj_value = std::max(shaken_obj_value, flip_obj_value);
+
+                    improved = improved_obj_value > current_obj_value;
+                    if (improved) {
+                        current_sol = shaken_sol;
+                        if (improving_move != -1) aplicarFlip(current_sol, inst, improving_move);
+                        current_obj_value = improved_obj_value;
+
+                        // Update the global best solution if necessary
+                        if (current_obj_value > melhorSol.valorObjetivo) {
+                            double old_best_objective = melhorSol.valorObjetivo;
+                            melhorSol.valorObjetivo = current_obj_value;
+                            melhorSol.itensSelecionados.assign(current_sol.x.begin(), current_sol.x.end());
+                            melhorSol.pesoTotal = current_sol.peso;
+                            registro.melhoria(current_sol.objetivo());
+                            cooperation.publicar(melhorSol.valorObjetivo, melhorSol.itensSelecionados);
+
+                            double improvement_ratio;
+                            // Avoid division by zero or very small numbers when calculating relative improvement
+                            if (abs(melhorSol.valorObjetivo) > 1e-9) {
+                                improvement_ratio = (melhorSol.valorObjetivo - old_best_objective) / melhorSol.valorObjetivo;
+                            } else {
+                                // If objective is zero or very small, any positive increase can be significant
+                                improvement_ratio = (melhorSol.valorObjetivo > old_best_objective) ? (threshold * 1.1) : 0.0;
+                            }
+
+                            if (improvement_ratio > threshold) {
+                                last_improvement_generation = generation; // Reset stagnation counter
+                            }
+                        }
                     }
                 }
-            } else {
-                k++; // Move to the next neighborhood if no improvement
+                // Reset to the closest neighborhood after an improvement, otherwise move on
+                k = improved ? 1 : k + 1;
             }
-        }
 
-        // Log the best solution of the iteration
-        if (log_file.is_open()) {
-            log_file << generation + 1 << ";" << melhorSol.valorObjetivo << ";" << melhorSol.pesoTotal << "\n";
-        }
+            #pragma omp single
+            {
+                // Log the best solution of the iteration
+                if (log_file.is_open()) {
+                    EscopoRastreio io("log", "io");
+                    log_file << generation + 1 << ";" << melhorSol.valorObjetivo << ";" << melhorSol.pesoTotal << "\n";
+                }
 
-        if (verbose && (generation % 100 == 0 || generation == max_generations - 1)) {
-            cout << "Iteration " << generation + 1 << ": Best Objective Value = " << melhorSol.valorObjetivo << endl;
-        }
+                if (verbose && (generation % 100 == 0 || generation == max_generations - 1)) {
+                    cout << "Iteration " << generation + 1 << ": Best Objective Value = " << melhorSol.valorObjetivo << endl;
+                }
+
+                if (std::shared_ptr<const SolucaoPublicada> elite = cooperation.importar(melhorSol.valorObjetivo)) {
+                    current_sol = criarEstado(inst, elite->itens);
+                    current_obj_value = static_cast<double>(elite->objetivo);
+                    melhorSol.valorObjetivo = elite->objetivo;
+                    melhorSol.itensSelecionados = elite->itens;
+                    melhorSol.pesoTotal = current_sol.peso;
+                }
 
-        // Stagnation stopping criterion
-        if (generation - last_improvement_generation > max_stagnated_iterations) {
-            if (verbose) {
-                cout << "VNS terminated due to stagnation at " << generation << " generations.\n";
+                // Stagnation stopping criterion (or the portfolio deadline)
+                stop = generation - last_improvement_generation > max_stagnated_iterations || cooperation.prazoEsgotado();
+                if (stop && verbose) {
+                    cout << "VNS terminated due to stagnation at " << generation << " generations.\n";
+                }
+                if (!stop && schedule.devido()) save_checkpoint(generation + 1);
             }
-            break; // Exit the main loop
+            if (stop) break; // Exit the main loop
         }
     }
 
@@ -196,9 +303,8 @@ Resultado vns(const Instance &inst, const fs::path &caminho,
         cout << "Total weight: " << melhorSol.pesoTotal << "/" << inst.capacity << endl;
     }
 
-    melhorSol.penalidadeTotal = calcularPenalidade(inst, melhorSol.itensSelecionados);
-    melhorSol.lucroTotal = melhorSol.valorObjetivo + melhorSol.penalidadeTotal;
-
     log_file.close();
-    return melhorSol;
+    Resultado res = avaliarResultado(inst, melhorSol.itensSelecionados);
+    registro.preencher(res);
+    return res;
 }
\ No newline at end of file
@@ -1,6 +1,14 @@
 #include "../utils/interpreter.hpp"
 #include "../utils/functions.hpp"
+#include "../utils/parallel.hpp"
+#include "../utils/estado.hpp"
+#include "../utils/guloso.hpp"
+#include "../utils/registro.hpp"
+#include "../utils/portfolio.hpp"
+#include "../utils/rastreio.hpp"
 #include <algorithm>
+#include <atomic>
+#include <climits>
 #include <filesystem>
 #include <random>
 #include <numeric>
@@ -8,151 +16,210 @@
 #include <omp.h>
 namespace fs = std::filesystem;
 
+struct LinhaLogGrasp {
+    int iteracao;
+    long long objetivo;
+    long long peso;
+};
+
+// Estado de uma thread do GRASP entre duas fronteiras de bloco (em linha de cache própria).
+struct alignas(64) LocalGrasp {
+    long long objetivo = LLONG_MIN;     // Melhor solução do bloco nesta thread
+    int iteracao = -1;                  // Iteração que a encontrou (a menor, em caso de empate)
+    std::vector<unsigned char> x;
+    long long avaliacoes = 0;
+    int executadas = 0;                 // Iterações do bloco executadas por esta thread
+    std::vector<LinhaLogGrasp> log;
+};
+
 Resultado grasp(const Instance& inst, const fs::path& caminho, int maxIter = 1000, double alpha = 0.2) {
+    RegistroExecucao registro;
+    Cooperacao cooperacao("grasp");   // Em portfólio: publica melhorias e respeita o prazo
     Resultado melhorSol;
     melhorSol.valorObjetivo = -1e9;
 
     int limiteSemMelhora = std::max(1, maxIter / 10);
     int semMelhora = 0;
 
-    std::ofstream log_file(caminho);
+    std::ofstream log_file;
+    if (!caminho.empty()) log_file.open(caminho); // Caminho vazio = sem log
     if (!log_file.is_open()) {
-        std::cerr << "Aviso: Nao foi possivel abrir o arquivo de log para escrita: " << caminho << std::endl;
+        if (!caminho.empty()) std::cerr << "Aviso: Nao foi possivel abrir o arquivo de log para escrita: " << caminho << std::endl;
     } else {
         log_file << "Iteracao;ValorObjetivo;Peso\n";
     }
 
+    // Modelo de custo: uma iteração GRASP faz ao menos ~4n avaliações incrementais
+    // (construção + passadas de adição/remoção).
+    EstadoSolucao amostra = criarEstadoVazio(inst);
+    int tamAmostra = std::min(inst.numItems, 64);
+    double custoAvaliacao = medirCustoNs([&]() {
+        long long soma = 0;
+        for (int j = 0; j < tamAmostra; ++j) soma += deltaObjetivoFlip(amostra, inst, j);
+        return soma;
+    }) / std::max(tamAmostra, 1);
+    double custoIteracao = 4.0 * inst.numItems * custoAvaliacao;
+    PlanoParalelo plano = planejarParalelismo(maxIter, custoIteracao, 2);
+
+    // Blocos grandes o suficiente para que a sincronização entre blocos custe < ~1% do bloco,
+    // mas sem ultrapassar o critério de parada por estagnação.
+    int blocoParalelo = std::max(10, plano.threads * 4);
+    if (plano.threads > 1) {
+        double custoSinc = custoSincronizacaoNs(plano.threads);
+        int minimo = static_cast<int>(100.0 * custoSinc * plano.threads / std::max(custoIteracao, 1.0)) + 1;
+        blocoParalelo = std::max(blocoParalelo, minimo);
+    }
+    blocoParalelo = std::min(blocoParalelo, std::max(1, limiteSemMelhora));
+
+    const bool grandeEscala = modoGrandeEscala(inst);
+
     int iteracao = 0;
-    const int blocoParalelo = 10;  // Número de iterações por bloco paralelo
+    int blocosExecutados = 0;
+    bool continuar = true;
+
+    // Cada thread guarda a melhor solução do bloco; o objetivo publicado (CAS, sem travas) só filtra
+    // quem precisa copiar a solução. Na fronteira do bloco, as locais são fundidas na incumbente
+    // por (objetivo, menor iteração), o que torna o resultado independente da ordem de chegada.
+    std::vector<LocalGrasp> locais(plano.threads);
+    std::atomic<long long> objetivoPublicado{LLONG_MIN};
+    std::vector<LinhaLogGrasp> linhasBloco;
+
+    auto fundirBloco = [&]() {
+        const LocalGrasp* melhor = nullptr;
+        int executadas = 0;
+        for (LocalGrasp& local : locais) {
+            executadas += local.executadas;
+            registro.contar(local.avaliacoes);
+            if (local.iteracao >= 0 && (!melhor || local.objetivo > melhor->objetivo ||
+                                        (local.objetivo == melhor->objetivo && local.iteracao < melhor->iteracao))) {
+                melhor = &local;
+            }
+        }
+        if (melhor && melhor->objetivo > melhorSol.valorObjetivo) {
+            melhorSol = avaliarResultado(inst, std::vector<bool>(melhor->x.begin(), melhor->x.end()));
+            registro.melhoria(melhorSol.valorObjetivo);
+            semMelhora = iteracao + blocosExecutados - (melhor->iteracao + 1);   // Iterações após a melhora
+        } else {
+            semMelhora += executadas;
+        }
 
-    while (iteracao < maxIter && semMelhora < limiteSemMelhora) {
-        int blocosExecutados = std::min(blocoParalelo, maxIter - iteracao);
+        if (log_file.is_open()) {
+            EscopoRastreio io("log", "io");
+            linhasBloco.clear();
+            for (const LocalGrasp& local : locais) linhasBloco.insert(linhasBloco.end(), local.log.begin(), local.log.end());
+            std::sort(linhasBloco.begin(), linhasBloco.end(),
+                      [](const LinhaLogGrasp& a, const LinhaLogGrasp& b) { return a.iteracao < b.iteracao; });
+            for (const auto& l : linhasBloco) log_file << l.iteracao << ";" << l.objetivo << ";" << l.peso << "\n";
+        }
 
-        #pragma omp parallel
-        {
-            std::mt19937 rng(std::random_device{}() + omp_get_thread_num());
-            Resultado melhorLocal;
-            melhorLocal.valorObjetivo = -1e9;
+        for (LocalGrasp& local : locais) {
+            local.objetivo = LLONG_MIN;
+            local.iteracao = -1;
+            local.avaliacoes = 0;
+            local.executadas = 0;
+            local.log.clear();
+        }
+    };
+
+    // Uma única equipe de threads para toda a execução; blocos são separados por barreiras.
+    #pragma omp parallel num_threads(plano.threads) if(plano.threads > 1) proc_bind(close)
+    {
+        EscopoRastreio regiao("grasp: regiao paralela", "paralelo");
+        while (true) {
+            #pragma omp single
+            {
+                fundirBloco();
+                iteracao += blocosExecutados;
+                continuar = iteracao < maxIter && semMelhora < limiteSemMelhora && !cooperacao.prazoEsgotado();
+                blocosExecutados = std::min(blocoParalelo, maxIter - iteracao);
+            }
+            if (!continuar) break;
 
-            #pragma omp for schedule(dynamic)
+            #pragma omp for schedule(dynamic, plano.chunk) nowait
             for (int i = 0; i < blocosExecutados; ++i) {
-                std::vector<bool> selecionado(inst.numItems, false);
-                int pesoAtual = 0, lucroAtual = 0;
-
-                std::vector<int> candidatos(inst.numItems);
-                std::iota(candidatos.begin(), candidatos.end(), 0);
-                std::sort(candidatos.begin(), candidatos.end(), [&](int a, int b) {
-                    return (double)inst.profits[a] / inst.weights[a] > (double)inst.profits[b] / inst.weights[b];
-                });
-
-                while (!candidatos.empty()) {
-                    int limiteRCL = std::max(1, (int)(alpha * candidatos.size()));
-                    std::uniform_int_distribution<int> dist(0, limiteRCL - 1);
-                    int escolhido = candidatos[dist(rng)];
-
-                    int item = candidatos[escolhido];
-                    if (pesoAtual + inst.weights[item] <= inst.capacity) {
-                        selecionado[item] = true;
-                        pesoAtual += inst.weights[item];
-                        lucroAtual += inst.profits[item];
-                    }
+                EscopoRastreio lote("grasp: iteracao", "avaliacao");
+                // Estado incremental: cada movimento é avaliado por delta, sem copiar a solução.
+                EstadoSolucao estado = criarEstadoVazio(inst);
+                long long avaliacoes = inst.numItems;   // Chaves iniciais da construção
 
-                    candidatos.erase(candidatos.begin() + escolhido);
-                }
+                // Gerador derivado da semente e do número da iteração: o resultado não depende
+                // de qual thread executa a iteração
+                std::seed_seq sementes{registro.semente, static_cast<unsigned>(iteracao + i)};
+                std::mt19937 rng(sementes);
+
+                // Construção: RCL extraída do heap de valores marginais (lucro - penalidade disparada)
+                construirGuloso(inst, estado, alpha, rng);
 
                 bool melhorou = true;
                 while (melhorou) {
                     melhorou = false;
-                    int objetivoAtual = get_objective_value(selecionado, inst);
-                    
+                    avaliacoes += 2LL * inst.numItems;
+
                     // Melhoria por adição
                     for (int i = 0; i < inst.numItems; ++i) {
-                        if (!selecionado[i] && pesoAtual + inst.weights[i] <= inst.capacity) {
-                            selecionado[i] = true;
-                            int novoObjetivo = get_objective_value(selecionado, inst);
-                            if (novoObjetivo > objetivoAtual) {
-                                pesoAtual += inst.weights[i];
-                                lucroAtual += inst.profits[i];
-                                melhorou = true;
-                                break;
-                            } else {
-                                selecionado[i] = false;
-                            }
+                        if (!estado.x[i] && viavelAposFlip(estado, inst, i) && deltaObjetivoFlip(estado, inst, i) > 0) {
+                            aplicarFlip(estado, inst, i);
+                            melhorou = true;
                         }
                     }
 
                     // Melhoria por remoção
                     for (int i = 0; i < inst.numItems; ++i) {
-                        if (selecionado[i]) {
-                            selecionado[i] = false;
-                            int novoObjetivo = get_objective_value(selecionado, inst);
-                            if (novoObjetivo > objetivoAtual) {
-                                pesoAtual -= inst.weights[i];
-                                lucroAtual -= inst.profits[i];
-                                melhorou = true;
-                                break;
-                            } else {
-                                selecionado[i] = true;
-                            }
+                        if (estado.x[i] && deltaObjetivoFlip(estado, inst, i) > 0) {
+                            aplicarFlip(estado, inst, i);
+                            melhorou = true;
                         }
                     }
-
-                    // Melhoria por troca
-                    for (int i = 0; i < inst.numItems; ++i) {
-                        if (!selecionado[i]) {
-                            for (int j = 0; j < inst.numItems; ++j) {
-                                if (selecionado[j]) {
-                                    int novoPeso = pesoAtual - inst.weights[j] + inst.weights[i];
-                                    if (novoPeso > inst.capacity) continue;
-
-                                    selecionado[i] = true;
-                                    selecionado[j] = false;
-
-                                    int novoObjetivo = get_objective_value(selecionado, inst);
-                                    if (novoObjetivo > objetivoAtual) {
-                                        pesoAtual = novoPeso;
-                                        lucroAtual = lucroAtual - inst.profits[j] + inst.profits[i];
-                                        melhorou = true;
-                                        break;
-                                    } else {
-                                        selecionado[i] = false;
-                                        selecionado[j] = true;
-                                    }
-                                }
+                    if (melhorou || grandeEscala) continue;
+
+                    // Melhoria por troca (O(n²); desligada no modo de grande escala)
+                    for (int i = 0; i < inst.numItems && !melhorou; ++i) {
+                        if (estado.x[i]) continue;
+                        for (int j = 0; j < inst.numItems; ++j) {
+                            if (!estado.x[j]) continue;
+                            long long novoPeso = estado.peso - inst.weights[j] + inst.weights[i];
+                            if (novoPeso > inst.capacity) continue;
+
+                            avaliacoes++;
+                            if (deltaObjetivoTroca(estado, inst, i, j) > 0) {
+                                aplicarFlip(estado, inst, j);
+                                aplicarFlip(estado, inst, i);
+                                melhorou = true;
+                                break;
                             }
-                            if (melhorou) break;
                         }
                     }
                 }
 
-                int objetivo = get_objective_value(selecionado, inst);
-                Resultado atual;
-                atual.valorObjetivo = objetivo;
-                atual.pesoTotal = pesoAtual;
-                atual.lucroTotal = lucroAtual;
-                atual.penalidadeTotal = objetivo - lucroAtual;
-                atual.itensSelecionados = selecionado;
-
-                #pragma omp critical
-                {
-                    if (log_file.is_open())
-                        log_file << (iteracao + i + 1) << ";" << objetivo << ";" << pesoAtual << "\n";
-
-                    if (atual.valorObjetivo > melhorSol.valorObjetivo) {
-                        melhorSol = atual;
-                        semMelhora = 0;
-                        // std::cout << "Melhor FO ate agora (iteracao " << (iteracao + i + 1) << "): "
-                                //   << melhorSol.valorObjetivo << " / Peso: "
-                                //   << melhorSol.pesoTotal << "/" << inst.capacity << "\n";
-                    } else {
-                        semMelhora++;
+                long long objetivo = estado.objetivo();
+                LocalGrasp& local = locais[omp_get_thread_num()];
+                local.avaliacoes += avaliacoes;
+                local.executadas++;
+                if (log_file.is_open()) local.log.push_back({iteracao + i + 1, objetivo, estado.peso});
+
+                // Só copia a solução se ela empatar ou superar o objetivo já publicado
+                long long publicado = objetivoPublicado.load(std::memory_order_relaxed);
+                if (objetivo >= publicado && (objetivo > local.objetivo ||
+                                              (objetivo == local.objetivo && iteracao + i < local.iteracao))) {
+                    local.objetivo = objetivo;
+                    local.iteracao = iteracao + i;
+                    local.x = estado.x;
+                    bool venceu = false;
+                    while (objetivo > publicado && !venceu) {
+                        venceu = objetivoPublicado.compare_exchange_weak(publicado, objetivo, std::memory_order_relaxed);
                     }
+                    if (venceu) cooperacao.publicar(estado);   // Em portfólio, a melhora sai na hora
                 }
             }
+            // Barreira explícita (o 'for' é nowait) para que o desbalanceamento entre threads
+            // apareça no rastreio como espera
+            {
+                EscopoRastreio barreira("barreira", "sincronizacao");
+                #pragma omp barrier
+            }
         }
-
-        iteracao += blocosExecutados;
     }
 
+    registro.preencher(melhorSol);
     return melhorSol;
 }
@@ -0,0 +1,57 @@
+#include "../utils/interpreter.hpp"
+#include "../utils/functions.hpp"
+#include "../utils/estado.hpp"
+#include "../utils/guloso.hpp"
+#include "../utils/registro.hpp"
+#include <filesystem>
+#include <random>
+namespace fs = std::filesystem;
+
+/**
+ * @brief Solver guloso rápido: construção ciente das penalidades (heap indexado de valores
+ *        marginais) seguida de passadas de adição/remoção até não haver melhora.
+ * @param inst A instância do problema.
+ * @param caminho Arquivo de log com o valor final.
+ * @return Um struct Resultado com a solução construída e suas métricas.
+ */
+Resultado guloso(const Instance& inst, const fs::path& caminho) {
+    RegistroExecucao registro;
+    EstadoSolucao estado = criarEstadoVazio(inst);
+    std::mt19937 rng(0);   // Não sorteia nada com alpha = 0
+    construirGuloso(inst, estado, 0.0, rng);
+
+    // Itens que entraram antes de seus conjuntos ficarem cheios podem ter ficado
+    // com contribuição negativa; removê-los pode abrir espaço para outros.
+    registro.contar(inst.numItems);
+    bool melhorou = true;
+    while (melhorou) {
+        melhorou = false;
+        registro.contar(2LL * inst.numItems);
+        for (int j = 0; j < inst.numItems; ++j) {
+            if (estado.x[j] && deltaObjetivoFlip(estado, inst, j) > 0) {
+                aplicarFlip(estado, inst, j);
+                melhorou = true;
+            }
+        }
+        for (int j = 0; j < inst.numItems; ++j) {
+            if (!estado.x[j] && viavelAposFlip(estado, inst, j) && deltaObjetivoFlip(estado, inst, j) > 0) {
+                aplicarFlip(estado, inst, j);
+                melhorou = true;
+            }
+        }
+    }
+
+    std::ofstream log_file;
+    if (!caminho.empty()) log_file.open(caminho); // Caminho vazio = sem log
+    if (!log_file.is_open()) {
+        if (!caminho.empty()) std::cerr << "Aviso: Nao foi possivel abrir o arquivo de log para escrita: " << caminho << std::endl;
+    } else {
+        log_file << "Iteracao;ValorObjetivo;Peso\n";
+        log_file << 1 << ";" << estado.objetivo() << ";" << estado.peso << "\n";
+    }
+
+    registro.melhoria(estado.objetivo());
+    Resultado res = resultadoDoEstado(estado);
+    registro.preencher(res);
+    return res;
+}
@@ -0,0 +1,128 @@
+#include "../utils/structs.hpp"
+#include "../utils/functions.hpp"
+#include "../utils/parallel.hpp"
+#include "../utils/registro.hpp"
+#include "../utils/portfolio.hpp"
+#include "../utils/checkpoint.hpp"
+#include "../utils/parametros.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <omp.h>
+namespace fs = std::filesystem;
+
+// Definido em solvers.cpp (que inclui este arquivo).
+Resultado executarSolver(const std::string& algoritmo, const Instance& inst, const fs::path& caminho,
+                         const Parametros& params);
+
+// Solvers executados lado a lado pelo portfólio.
+const std::vector<std::string> MEMBROS_PORTFOLIO = {"grasp", "vns", "tabu", "genetic"};
+
+// Configuração por thread (orçamento, semente, portfólio, acompanhamento e checkpoint) salva na
+// criação e restaurada na destruição. O membro 0 roda na thread chamadora, cuja configuração
+// precisa sobreviver ao portfólio.
+struct EscopoConfiguracaoMembro {
+    int orcamento = orcamentoThreads;
+    bool tinhaSemente = temSementeFixada;
+    unsigned semente = sementeFixada;
+    ContextoPortfolio* portfolio = portfolioAtual;
+    Acompanhamento* acompanhamento = acompanhamentoAtual;
+    ConfigCheckpoint checkpoint = configCheckpoint;
+
+    ~EscopoConfiguracaoMembro() {
+        orcamentoThreads = orcamento;
+        temSementeFixada = tinhaSemente;
+        sementeFixada = semente;
+        portfolioAtual = portfolio;
+        acompanhamentoAtual = acompanhamento;
+        configCheckpoint = checkpoint;
+    }
+};
+
+/**
+ * @brief Portfólio: GRASP, VNS, Busca Tabu e GA ao mesmo tempo, até um prazo único.
+ *
+ * O orçamento de threads é repartido entre os membros (cada um abre sua própria equipe,
+ * aninhada). Todos compartilham um incumbente global sem travas: publicam suas melhorias, o
+ * GA recebe a elite como imigrante e TS/VNS recomeçam dela. Um membro que termina antes do
+ * prazo é reiniciado com nova semente, de modo que nenhuma thread fica ociosa.
+ *
+ * @param inst A instância do problema.
+ * @param caminho Arquivo de log (uma linha por melhoria do incumbente global).
+ * @param params Hiperparâmetros dos membros.
+ * @param tempoSeg Prazo de relógio, em segundos.
+ * @return A melhor solução publicada por qualquer membro.
+ */
+Resultado portfolio(const Instance& inst, const fs::path& caminho, const Parametros& params, double tempoSeg = 60.0) {
+    RegistroExecucao registro;
+    ContextoPortfolio ctx;
+    ctx.prazo = ctx.incumbente.inicio +
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(tempoSeg));
+    Acompanhamento* acompanhamento = acompanhamentoAtual;   // Repassado aos membros
+    if (acompanhamento) ctx.prazo = std::min(ctx.prazo, acompanhamento->prazo);
+
+    // Orçamento de threads repartido entre os membros (ao menos 1 cada)
+    const int membros = MEMBROS_PORTFOLIO.size();
+    int total = threadsDisponiveis();
+    std::vector<int> orcamento(membros);
+    for (int m = 0; m < membros; ++m) orcamento[m] = std::max(1, total / membros + (m < total % membros ? 1 : 0));
+
+    std::vector<long long> avaliacoes(membros, 0);
+    std::vector<int> rodadas(membros, 0);
+    std::vector<std::string> erros(membros);
+
+    int niveisAnteriores = omp_get_max_active_levels();
+    omp_set_max_active_levels(std::max(niveisAnteriores, 2));
+
+    #pragma omp parallel for schedule(static, 1) num_threads(membros)
+    for (int m = 0; m < membros; ++m) {
+        EscopoConfiguracaoMembro escopo;
+        definirOrcamentoThreads(orcamento[m]);
+        portfolioAtual = &ctx;
+        acompanhamentoAtual = acompanhamento;
+        configCheckpoint = ConfigCheckpoint{};   // Membros não gravam checkpoints
+        unsigned semente = registro.semente + 1000003u * m;
+        try {
+            while (std::chrono::steady_clock::now() < ctx.prazo && !(acompanhamento && acompanhamento->esgotado())) {
+                definirSemente(semente++);
+                Resultado r = executarSolver(MEMBROS_PORTFOLIO[m], inst, "", params);
+                ctx.incumbente.publicar(r.valorObjetivo, r.itensSelecionados, MEMBROS_PORTFOLIO[m]);
+                avaliacoes[m] += r.avaliacoes;
+                rodadas[m]++;
+            }
+        } catch (const std::exception& e) {
+            erros[m] = e.what();
+        }
+    }
+    omp_set_max_active_levels(niveisAnteriores);
+
+    for (int m = 0; m < membros; ++m) {
+        if (!erros[m].empty()) std::cerr << "Aviso: " << MEMBROS_PORTFOLIO[m] << " falhou no portfolio: " << erros[m] << "\n";
+        registro.contar(avaliacoes[m]);
+    }
+
+    // Trajetória do incumbente global: as publicações vencedoras, da mais antiga à mais recente
+    std::vector<PublicacaoIncumbente> cadeia = ctx.incumbente.trajetoria();
+    for (const auto& s : cadeia) registro.trajetoria.push_back({s.tempoMs, s.objetivo, 0});
+
+    std::ofstream log_file;
+    if (!caminho.empty()) log_file.open(caminho); // Caminho vazio = sem log
+    if (!log_file.is_open()) {
+        if (!caminho.empty()) std::cerr << "Aviso: Nao foi possivel abrir o arquivo de log para escrita: " << caminho << std::endl;
+    } else {
+        log_file << "Tempo(ms);Origem;ValorObjetivo\n";
+        for (const auto& s : cadeia) log_file << s.tempoMs << ";" << s.origem << ";" << s.objetivo << "\n";
+        log_file << "# Membro;Threads;Execucoes;Avaliacoes\n";
+        for (int m = 0; m < membros; ++m) {
+            log_file << "# " << MEMBROS_PORTFOLIO[m] << ";" << orcamento[m] << ";" << rodadas[m] << ";" << avaliacoes[m] << "\n";
+        }
+    }
+
+    std::shared_ptr<const SolucaoPublicada> melhor = ctx.incumbente.ler();
+    Resultado res = melhor ? avaliarResultado(inst, melhor->itens)
+                           : avaliarResultado(inst, std::vector<bool>(inst.numItems, false));
+    registro.preencher(res);
+    return res;
+}
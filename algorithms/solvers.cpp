@@ -0,0 +1,54 @@
+#include "grasp.cpp"
+#include "TS.cpp"
+#include "GA.cpp"
+#include "VNS.cpp"
+#include "LNS.cpp"
+#include "greedy.cpp"
+#include "PT.cpp"
+#include "../utils/parametros.hpp"
+#include "../utils/rastreio.hpp"
+#include "../utils/selecao.hpp"
+#include "portfolio.cpp"
+#include "BB.cpp"
+#include <algorithm>
+#include <stdexcept>
+
+// Nomes aceitos por executarSolver, na ordem dos menus (além de "auto", que delega a um deles).
+const std::vector<std::string> ALGORITMOS = {"grasp", "vns", "tabu", "genetic", "lns", "guloso", "portfolio", "tempera", "exato"};
+
+/**
+ * @brief Executa o solver 'algoritmo' com os hiperparâmetros de 'params'.
+ * @param caminho Arquivo de log do solver (vazio = sem log).
+ */
+Resultado executarSolver(const std::string& algoritmo, const Instance& inst, const fs::path& caminho,
+                         const Parametros& params = parametrosPadrao()) {
+    if (algoritmo == "auto") {
+        EscolhaAuto escolha = escolherSolver(inst, params);
+        return executarSolver(escolha.algoritmo, inst, caminho, escolha.parametros);
+    }
+
+    // O nome do intervalo precisa sobreviver até a exportação: usa a cópia em ALGORITMOS
+    auto estavel = std::find(ALGORITMOS.begin(), ALGORITMOS.end(), algoritmo);
+    EscopoRastreio escopo(estavel != ALGORITMOS.end() ? estavel->c_str() : "solver", "solver");
+
+    auto p = [&](const char* nome) { return params.at(algoritmo + "." + nome); };
+    auto i = [&](const char* nome) { return static_cast<int>(p(nome)); };
+
+    if (algoritmo == "grasp") return grasp(inst, caminho, i("maxIter"), p("alpha"));
+    if (algoritmo == "vns") return vns(inst, caminho, i("max_generations"), p("maxGenEstagnated_ratio"),
+                                       p("threshold"), i("k_max"), i("movimentos_compostos") != 0);
+    if (algoritmo == "tabu") return tabu_search(inst, caminho, i("max_iter"), i("tabu_tenure"),
+                                                i("movimentos_compostos") != 0);
+    if (algoritmo == "genetic") return genetic_algorithm(inst, caminho, i("population_size"), i("max_generations"),
+                                                         p("crossover_rate"), p("mutation_rate"),
+                                                         p("maxGenEstagnated"), p("threshold"), i("avaliacao_lote") != 0);
+    if (algoritmo == "lns") return lns(inst, caminho, i("max_iter"), i("k_livres"),
+                                       static_cast<long long>(p("limite_nos")), p("maxIterEstagnado"));
+    if (algoritmo == "guloso") return guloso(inst, caminho);
+    if (algoritmo == "tempera") return tempera_paralela(inst, caminho, i("max_varreduras"), p("temp_min"), p("temp_max"),
+                                                        i("intervalo_troca"), i("replicas"), p("maxEstagnado"));
+    if (algoritmo == "exato") return branch_and_bound(inst, caminho, params, static_cast<long long>(p("limite_nos")),
+                                                      p("tempo_limite_seg"), i("incumbente_lns") != 0);
+    if (algoritmo == "portfolio") return portfolio(inst, caminho, params, p("tempo_seg"));
+    throw std::runtime_error("Algoritmo desconhecido: " + algoritmo);
+}
@@ -0,0 +1,159 @@
+#include "kpfs.h"
+#include "algorithms/solvers.cpp"
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+// Implementação da API de kpfs.h sobre executarSolver.
+
+namespace {
+
+// Monta a instância a partir dos arrays do chamador (O(n + Σ|conjunto|), sem arquivo nem
+// parsing). Os solvers trabalham sobre a struct Instance; a cópia custa o mesmo que indexar os
+// conjuntos, o que a execução faz de qualquer modo.
+Instance montarInstancia(const kpfs_instancia& in) {
+    if (in.num_itens < 0 || in.num_conjuntos < 0) throw std::invalid_argument("Dimensoes negativas");
+    if (in.num_itens > 0 && (!in.lucros || !in.pesos)) throw std::invalid_argument("Lucros ou pesos nulos");
+    if (in.num_conjuntos > 0 && (!in.inicio_conjunto || !in.permitidos || !in.custos)) {
+        throw std::invalid_argument("Conjuntos sem inicio_conjunto, permitidos ou custos");
+    }
+
+    Instance inst;
+    inst.numItems = in.num_itens;
+    inst.numSets = in.num_conjuntos;
+    inst.capacity = in.capacidade;
+    inst.profits.assign(in.lucros, in.lucros + in.num_itens);
+    inst.weights.assign(in.pesos, in.pesos + in.num_itens);
+    inst.forfeitSets.resize(in.num_conjuntos);
+    for (int s = 0; s < in.num_conjuntos; ++s) {
+        const int32_t inicio = in.inicio_conjunto[s], fim = in.inicio_conjunto[s + 1];
+        if (inicio < 0 || fim < inicio) throw std::invalid_argument("inicio_conjunto nao crescente no conjunto " + std::to_string(s));
+        if (fim > inicio && !in.itens_conjunto) throw std::invalid_argument("itens_conjunto nulo");
+        ForfeitSet& fs = inst.forfeitSets[s];
+        fs.nA = in.permitidos[s];
+        fs.forfeitCost = in.custos[s];
+        fs.items.assign(in.itens_conjunto + inicio, in.itens_conjunto + fim);
+        for (int item : fs.items) {
+            if (item < 0 || item >= in.num_itens) {
+                throw std::invalid_argument("Item fora do intervalo no conjunto " + std::to_string(s) + ": " + std::to_string(item));
+            }
+        }
+    }
+    indexarConjuntos(inst);
+    return inst;
+}
+
+Parametros montarParametros(const char* texto) {
+    Parametros params = parametrosPadrao();
+    if (!texto) return params;
+    std::string linhas(texto);
+    std::replace(linhas.begin(), linhas.end(), ';', '\n');
+    std::istringstream entrada(linhas);
+    lerParametros(entrada, params, true);
+    return params;
+}
+
+void copiarErro(char* erro, size_t tamanho, const std::string& mensagem) {
+    if (!erro || tamanho == 0) return;
+    size_t n = std::min(tamanho - 1, mensagem.size());
+    std::memcpy(erro, mensagem.data(), n);
+    erro[n] = '\0';
+}
+
+// Configuração por thread (semente, orçamento, acompanhamento) restaurada ao sair, mesmo com exceção.
+struct EscopoConfiguracao {
+    bool tinhaSemente = temSementeFixada;
+    unsigned semente = sementeFixada;
+    int orcamento = orcamentoThreads;
+    Acompanhamento* acompanhamento = acompanhamentoAtual;
+
+    ~EscopoConfiguracao() {
+        temSementeFixada = tinhaSemente;
+        sementeFixada = semente;
+        orcamentoThreads = orcamento;
+        acompanhamentoAtual = acompanhamento;
+    }
+};
+
+}  // namespace
+
+extern "C" void kpfs_config_padrao(kpfs_config* config) {
+    if (!config) return;
+    *config = kpfs_config{};
+    config->algoritmo = "auto";
+}
+
+extern "C" int kpfs_versao(void) {
+    return KPFS_VERSAO_API;
+}
+
+extern "C" int kpfs_resolver(const kpfs_instancia* instancia, const kpfs_config* config, unsigned char* selecao,
+                             kpfs_resultado* resultado, char* erro, size_t tamanho_erro) {
+    kpfs_config padrao;
+    kpfs_config_padrao(&padrao);
+    const kpfs_config& cfg = config ? *config : padrao;
+
+    Instance inst;
+    try {
+        if (!instancia) throw std::invalid_argument("Instancia nula");
+        inst = montarInstancia(*instancia);
+    } catch (const std::exception& e) {
+        copiarErro(erro, tamanho_erro, e.what());
+        return KPFS_ERRO_INSTANCIA;
+    }
+
+    std::string algoritmo = cfg.algoritmo ? cfg.algoritmo : "auto";
+    Parametros params;
+    try {
+        if (algoritmo != "auto" && std::find(ALGORITMOS.begin(), ALGORITMOS.end(), algoritmo) == ALGORITMOS.end()) {
+            throw std::invalid_argument("Algoritmo desconhecido: " + algoritmo);
+        }
+        params = montarParametros(cfg.parametros);
+    } catch (const std::exception& e) {
+        copiarErro(erro, tamanho_erro, e.what());
+        return KPFS_ERRO_CONFIG;
+    }
+
+    EscopoConfiguracao escopo;
+    Acompanhamento acompanhamento;
+    if (cfg.prazo_seg > 0) {
+        acompanhamento.prazo = acompanhamento.inicio + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                           std::chrono::duration<double>(cfg.prazo_seg));
+    }
+    if (cfg.progresso) {
+        acompanhamento.progresso = [&cfg](double tempoMs, long long objetivo, long long avaliacoes) {
+            return cfg.progresso(tempoMs, objetivo, avaliacoes, cfg.usuario) != 0;
+        };
+    }
+    acompanhamentoAtual = &acompanhamento;
+    definirOrcamentoThreads(cfg.threads);
+    if (cfg.fixar_semente) definirSemente(cfg.semente);
+    else temSementeFixada = false;
+
+    Resultado res;
+    try {
+        res = executarSolver(algoritmo, inst, "", params);
+    } catch (const std::exception& e) {
+        copiarErro(erro, tamanho_erro, e.what());
+        return KPFS_ERRO_SOLVER;
+    }
+    res.tempoMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - acompanhamento.inicio).count();
+
+    if (selecao) {
+        for (int j = 0; j < inst.numItems; ++j) selecao[j] = j < (int)res.itensSelecionados.size() && res.itensSelecionados[j];
+    }
+    if (resultado) {
+        resultado->objetivo = res.valorObjetivo;
+        resultado->lucro = res.lucroTotal;
+        resultado->peso = res.pesoTotal;
+        resultado->penalidade = res.penalidadeTotal;
+        resultado->tempo_ms = res.tempoMs;
+        resultado->avaliacoes = res.avaliacoes;
+        resultado->semente = res.semente;
+        resultado->interrompido = acompanhamento.esgotado();
+        resultado->otimo_provado = res.otimoProvado;
+        resultado->limite_superior = res.limiteSuperior;
+        resultado->gap = res.gap;
+    }
+    return KPFS_OK;
+}
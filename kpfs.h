@@ -0,0 +1,96 @@
+#ifndef KPFS_H
+#define KPFS_H
+/*
+ * API de biblioteca dos solvers KPFS (C e C++). A instância é montada pelo chamador em memória,
+ * sem arquivos: lucros, pesos e conjuntos de penalidade em formato CSR. O resultado é escrito em
+ * buffers do chamador, sem "outputs/".
+ *
+ * Compilação (kpfs.cpp é a única unidade de tradução da biblioteca):
+ *   g++ -O2 -fopenmp -fPIC -shared kpfs.cpp -o libkpfs.so
+ *   g++ -O2 -fopenmp -c kpfs.cpp -o kpfs.o && ar rcs libkpfs.a kpfs.o
+ *
+ * Chamadas simultâneas de threads distintas são permitidas (cada uma com sua configuração).
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define KPFS_VERSAO_API 1
+
+/* Códigos de retorno de kpfs_resolver. */
+#define KPFS_OK 0
+#define KPFS_ERRO_INSTANCIA 1  /* Dimensões negativas, ponteiro nulo ou item fora do intervalo */
+#define KPFS_ERRO_CONFIG 2     /* Algoritmo ou parâmetro desconhecido, valor inválido */
+#define KPFS_ERRO_SOLVER 3     /* Falha durante a execução (ex.: memória) */
+
+/*
+ * Instância descrita por arrays do chamador, que só precisam viver durante kpfs_resolver.
+ * Os itens do conjunto s são itens_conjunto[inicio_conjunto[s] .. inicio_conjunto[s + 1]).
+ */
+typedef struct {
+    int32_t num_itens;
+    int32_t num_conjuntos;
+    int64_t capacidade;
+    const int32_t* lucros;           /* [num_itens] */
+    const int32_t* pesos;            /* [num_itens] */
+    const int32_t* inicio_conjunto;  /* [num_conjuntos + 1], começa em 0 */
+    const int32_t* itens_conjunto;   /* [inicio_conjunto[num_conjuntos]], IDs em [0, num_itens) */
+    const int32_t* permitidos;       /* [num_conjuntos], nA: itens sem penalidade no conjunto */
+    const int32_t* custos;           /* [num_conjuntos], penalidade por item além de nA */
+} kpfs_instancia;
+
+/*
+ * Chamada a cada novo incumbente (objetivos estritamente crescentes, nunca simultaneamente),
+ * possivelmente de uma thread do solver. Retornar 0 interrompe a busca: kpfs_resolver devolve
+ * a melhor solução até ali.
+ */
+typedef int (*kpfs_progresso)(double tempo_ms, int64_t objetivo, int64_t avaliacoes, void* usuario);
+
+typedef struct {
+    const char* algoritmo;      /* "grasp", "vns", "tabu", "genetic", "lns", "guloso", "portfolio",
+                                   "tempera", "exato" ou "auto" (NULL = "auto") */
+    const char* parametros;     /* "algoritmo.nome=valor", separados por ';' ou '\n' (NULL = padrões) */
+    double prazo_seg;           /* Prazo de relógio (<= 0 = sem prazo) */
+    int threads;                /* Orçamento de threads (0 = todas) */
+    int fixar_semente;          /* Se != 0, usa 'semente' (execução reprodutível) */
+    uint32_t semente;
+    kpfs_progresso progresso;   /* Opcional */
+    void* usuario;              /* Repassado a 'progresso' */
+} kpfs_config;
+
+typedef struct {
+    int64_t objetivo;
+    int64_t lucro;
+    int64_t peso;
+    int64_t penalidade;
+    double tempo_ms;
+    int64_t avaliacoes;
+    uint32_t semente;
+    int interrompido;           /* Prazo esgotado ou cancelado pelo callback */
+    int otimo_provado;          /* Só o "exato" prova otimalidade */
+    double limite_superior;     /* "exato": limite superior (gap < 0 nos demais) */
+    double gap;
+} kpfs_resultado;
+
+/* Preenche 'config' com os padrões: "auto", sem prazo, todas as threads, semente sorteada. */
+void kpfs_config_padrao(kpfs_config* config);
+
+/*
+ * Resolve a instância. 'selecao' (opcional, num_itens bytes) recebe 1 para os itens escolhidos;
+ * 'resultado' (opcional) recebe as métricas; 'erro' (opcional, 'tamanho_erro' bytes) recebe a
+ * mensagem quando o retorno não é KPFS_OK.
+ */
+int kpfs_resolver(const kpfs_instancia* instancia, const kpfs_config* config, unsigned char* selecao,
+                  kpfs_resultado* resultado, char* erro, size_t tamanho_erro);
+
+/* Versão da API (KPFS_VERSAO_API da biblioteca compilada). */
+int kpfs_versao(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
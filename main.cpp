@@ -1,7 +1,5 @@
-#include "algorithms/grasp.cpp"
-#include "algorithms/TS.cpp"
-#include "algorithms/GA.cpp"
-#include "algorithms/VNS.cpp"
+#include "algorithms/solvers.cpp"
+#include "utils/reordenacao.hpp"
 #include <iostream>
 // Gera o caminho correspondente em "outputs/"
 fs::path gerarCaminhoOutput(const fs::path& inputPath, const std::string& algoritmo) {
@@ -24,6 +22,12 @@ void salvarResultado(const fs::path& caminho, const Resultado& res, const Instan
     out << "Valor objetivo: " << res.valorObjetivo << "\n";
     out << "Peso na Mochila:" << res.pesoTotal << "/" << inst.capacity <<"\n";
     out << "Tempo (ms): " << res.tempoMs << "\n";
+    out << "Semente: " << res.semente << "\n";
+    out << "Avaliacoes: " << res.avaliacoes << " (melhor em " << res.tempoAteMelhorMs << " ms)\n";
+    if (res.gap >= 0) {
+        out << (res.otimoProvado ? "Otimo provado" : "Otimo nao provado") << " (limite superior " << res.limiteSuperior
+            << ", gap " << 100.0 * res.gap << "%), " << res.nos << " nos, " << res.nosPorSegundo << " nos/s\n";
+    }
     out << "Itens selecionados (por índice):\n";
     for (size_t i = 0; i < res.itensSelecionados.size(); ++i) {
         if (res.itensSelecionados[i])
@@ -34,55 +38,139 @@ void salvarResultado(const fs::path& caminho, const Resultado& res, const Instan
 
 int main(int argc, char* argv[]) {
     if (argc < 2) {
-        std::cerr << "Uso: " << argv[0] << " <caminho_para_instancia>\n";
+        std::cerr << "Uso: " << argv[0] << " <caminho_para_instancia> [--threads N] [--params arquivo.cfg] [--semente S]"
+                  << " [--checkpoint arquivo] [--intervalo-checkpoint S] [--resume arquivo] [--trace arquivo.json] [--renumerar]"
+                  << " [--auto] [--regras arquivo]\n";
         return 1;
     }
-
+    Parametros params = parametrosPadrao();
+    fs::path arquivoCheckpoint, arquivoRetomada, arquivoRastreio;
+    double intervaloCheckpoint = 300.0;
+    bool renumerar = false;
     std::string algoritmo;
-    std::cout << "Selecione o algoritmo:\n";
-    std::cout << "1 - GRASP\n";
-    std::cout << "2 - VNS\n";
-    std::cout << "3 - Tabu Search\n";
-    std::cout << "4 - Genetic Algorithm\n";
-    std::cout << ">> ";
-    int opcao;
-    std::cin >> opcao;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) definirOrcamentoThreads(std::stoi(argv[++i]));
+        else if (arg == "--semente" && i + 1 < argc) definirSemente(std::stoul(argv[++i]));
+        else if (arg == "--checkpoint" && i + 1 < argc) arquivoCheckpoint = argv[++i];
+        else if (arg == "--intervalo-checkpoint" && i + 1 < argc) intervaloCheckpoint = std::stod(argv[++i]);
+        else if (arg == "--resume" && i + 1 < argc) arquivoRetomada = argv[++i];
+        else if (arg == "--trace" && i + 1 < argc) arquivoRastreio = argv[++i];
+        else if (arg == "--renumerar") renumerar = true;
+        else if (arg == "--auto") algoritmo = "auto";
+        else if (arg == "--regras" && i + 1 < argc) {
+            try {
+                definirRegrasAuto(carregarRegras(argv[++i]));
+            } catch (const std::exception& e) {
+                std::cerr << "Erro: " << e.what() << "\n";
+                return 1;
+            }
+        }
+        else if (arg == "--params" && i + 1 < argc) {
+            try {
+                carregarParametros(argv[++i], params);
+            } catch (const std::exception& e) {
+                std::cerr << "Erro: " << e.what() << "\n";
+                return 1;
+            }
+        }
+    }
 
-    switch (opcao) {
-        case 1: algoritmo = "grasp"; break;
-        case 2: algoritmo = "vns"; break;
-        case 3: algoritmo = "tabu"; break;
-        case 4: algoritmo = "genetic"; break;
-        default:
-            std::cerr << "Opção inválida.\n";
+    // Retomada: o algoritmo vem do checkpoint, que continua sendo atualizado
+    if (!arquivoRetomada.empty()) {
+        try {
+            algoritmo = algoritmoDoCheckpoint(arquivoRetomada);
+        } catch (const std::exception& e) {
+            std::cerr << "Erro: " << e.what() << "\n";
             return 1;
+        }
+        definirRetomada(arquivoRetomada);
+        if (arquivoCheckpoint.empty()) arquivoCheckpoint = arquivoRetomada;
+        std::cout << "Retomando " << algoritmo << " de " << arquivoRetomada << "\n";
+    } else if (algoritmo.empty()) {
+        std::cout << "Selecione o algoritmo:\n";
+        std::cout << "1 - GRASP\n";
+        std::cout << "2 - VNS\n";
+        std::cout << "3 - Tabu Search\n";
+        std::cout << "4 - Genetic Algorithm\n";
+        std::cout << "5 - LNS\n";
+        std::cout << "6 - Guloso (heap de valores marginais)\n";
+        std::cout << "7 - Portfolio (GRASP + VNS + Tabu + GA em paralelo)\n";
+        std::cout << "8 - Tempera paralela (recozimento simulado com troca de replicas)\n";
+        std::cout << "9 - Automatico (escolhe o solver pelas caracteristicas da instancia)\n";
+        std::cout << "10 - Branch-and-bound exato (paralelo, com roubo de trabalho)\n";
+        std::cout << ">> ";
+        int opcao;
+        std::cin >> opcao;
+
+        switch (opcao) {
+            case 1: algoritmo = "grasp"; break;
+            case 2: algoritmo = "vns"; break;
+            case 3: algoritmo = "tabu"; break;
+            case 4: algoritmo = "genetic"; break;
+            case 5: algoritmo = "lns"; break;
+            case 6: algoritmo = "guloso"; break;
+            case 7: algoritmo = "portfolio"; break;
+            case 8: algoritmo = "tempera"; break;
+            case 9: algoritmo = "auto"; break;
+            case 10: algoritmo = "exato"; break;
+            default:
+                std::cerr << "Opção inválida.\n";
+                return 1;
+        }
     }
+
     std::string caminho = argv[1];
     try {
         Instance inst = lerInstancia(caminho);
+        Renumeracao renumeracao;
+        if (renumerar) {
+            double antes = dispersaoConjuntos(inst);
+            renumeracao = renumerarItens(inst);
+            std::cout << "Itens renumerados (RCM): dispersao dos conjuntos " << antes << " -> " << dispersaoConjuntos(inst) << "\n";
+        }
+        if (algoritmo == "auto") {
+            EscolhaAuto escolha = escolherSolver(inst, params);
+            std::cout << "Auto:";
+            for (int c = 0; c < NUM_CARACTERISTICAS; ++c) std::cout << " " << NOMES_CARACTERISTICAS[c] << "=" << escolha.caracteristicas[c];
+            std::cout << "\n  -> " << escolha.algoritmo << " (regra " << escolha.regra + 1 << ")\n";
+            algoritmo = escolha.algoritmo;
+            params = escolha.parametros;
+        }
+        if (!arquivoCheckpoint.empty()) {   // Depois do auto, que já escolheu o solver
+            if (algoritmo != "genetic" && algoritmo != "tabu" && algoritmo != "vns") {
+                std::cerr << "Aviso: checkpoint disponivel apenas para genetic, tabu e vns.\n";
+            }
+            definirCheckpoint(arquivoCheckpoint, intervaloCheckpoint);
+        }
         fs::path caminhoOutput = gerarCaminhoOutput(caminho, algoritmo);
         fs::create_directories(caminhoOutput.parent_path());
 
+        if (!arquivoRastreio.empty()) iniciarRastreio();
         auto start = std::chrono::high_resolution_clock::now();
 
-        Resultado res;
-        if (algoritmo == "grasp") res = grasp(inst, caminhoOutput);
-        else if (algoritmo == "vns") res = vns(inst, caminhoOutput);
-        else if (algoritmo == "tabu") res = tabu_search(inst, caminhoOutput);
-        else if(algoritmo == "genetic") res = genetic_algorithm(inst, caminhoOutput);
-        else {
-            std::cerr << "Algoritmo desconhecido.\n";
-            return 1;
-        }
+        Resultado res = executarSolver(algoritmo, inst, caminhoOutput, params);
 
         auto end = std::chrono::high_resolution_clock::now();
         res.tempoMs = std::chrono::duration<double, std::milli>(end - start).count();
+        if (renumerar) restaurarNumeracao(res, renumeracao);   // Itens nos IDs do arquivo
         salvarResultado(caminhoOutput, res, inst);
 
         std::cout << "Lucro: " << res.lucroTotal
                 << ", Penalidade: " << res.penalidadeTotal
                 << ", Objetivo: " << res.valorObjetivo
                 << ", Tempo: " << res.tempoMs << " ms\n";
+        if (res.gap >= 0) {
+            std::cout << (res.otimoProvado ? "Otimo provado" : "Limite atingido") << ": limite superior " << res.limiteSuperior
+                      << ", gap " << 100.0 * res.gap << "%, " << res.nos << " nos (" << res.nosPorSegundo << " nos/s)\n";
+        }
+
+        if (!arquivoRastreio.empty()) {
+            long long descartados = exportarRastreio(arquivoRastreio);
+            std::cout << "Rastreio gravado em " << arquivoRastreio;
+            if (descartados > 0) std::cout << " (" << descartados << " eventos descartados: buffers cheios)";
+            std::cout << "\n";
+        }
     } catch (const std::exception& e) {
         std::cerr << "Erro: " << e.what() << "\n";
         return 1;
@@ -4,13 +4,16 @@
 #include <fstream>
 #include <chrono>
 #include <vector>
+#include <map>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <algorithm>
 
 #include "utils/structs.hpp"
 #include "utils/interpreter.hpp"
-#include "algorithms/grasp.cpp"
-#include "algorithms/VNS.cpp"
-#include "algorithms/TS.cpp"
-#include "algorithms/GA.cpp"
+#include "algorithms/solvers.cpp"
+#include "utils/reordenacao.hpp"
 
 namespace fs = std::filesystem;
 
@@ -36,6 +39,8 @@ void salvarResultado(const fs::path& caminho, const Resultado& res, const Instan
     out << "Valor objetivo: " << res.valorObjetivo << "\n";
     out << "Peso na Mochila:" << res.pesoTotal << "/" << inst.capacity <<"\n";
     out << "Tempo (ms): " << res.tempoMs << "\n";
+    out << "Semente: " << res.semente << "\n";
+    out << "Avaliacoes: " << res.avaliacoes << " (melhor em " << res.tempoAteMelhorMs << " ms)\n";
     out << "Itens selecionados (por índice):\n";
     for (size_t i = 0; i < res.itensSelecionados.size(); ++i) {
         if (res.itensSelecionados[i])
@@ -44,13 +49,287 @@ void salvarResultado(const fs::path& caminho, const Resultado& res, const Instan
     out << "\n";
 }
 
-int main() {
+// ---------------------------------------------------------------------------------------
+// Modo estatístico (--repeticoes R): cada par (instância, algoritmo) roda R vezes com sementes
+// registradas; cada execução vira um registro JSONL/CSV e, ao final, são gerados o resumo
+// agregado e as distribuições de tempo até o alvo (TTT).
+// ---------------------------------------------------------------------------------------
+
+struct ConfigEstatistica {
+    int repeticoes = 0;
+    unsigned sementeBase = 1;
+    std::vector<std::string> algoritmos = ALGORITMOS;
+    fs::path instancias = "instances";
+    fs::path saida = "resultados";
+    fs::path melhoresConhecidos;      // Opcional: linhas "instancia;valor"
+    double fracaoAlvo = 0.99;         // Alvo do TTT = fração do melhor conhecido
+    bool renumerar = false;           // Renumeração RCM dos itens antes de resolver
+    fs::path regrasSaida;             // Opcional: gera a tabela de regras do "auto"
+    double pesoTempo = 0.1;           // Custo de 1 s de execução, em pontos de gap%, ao gerar as regras
+};
+
+struct Execucao {
+    std::string instancia, algoritmo, trajetoria;
+    int repeticao;
+    Resultado res;
+};
+
+std::string escaparJson(const std::string& texto) {
+    std::string saida;
+    for (char c : texto) {
+        if (c == '"' || c == '\\') saida += '\\';
+        saida += c;
+    }
+    return saida;
+}
+
+// Quantil (interpolação linear) de valores já ordenados.
+double quantil(const std::vector<double>& ordenados, double q) {
+    if (ordenados.empty()) return 0.0;
+    double pos = q * (ordenados.size() - 1);
+    size_t i = static_cast<size_t>(pos);
+    if (i + 1 >= ordenados.size()) return ordenados.back();
+    return ordenados[i] + (pos - i) * (ordenados[i + 1] - ordenados[i]);
+}
+
+// Gap percentual para o melhor conhecido (maximização).
+double gapPercentual(double valor, double melhor) {
+    return melhor != 0.0 ? 100.0 * (melhor - valor) / std::abs(melhor) : 0.0;
+}
+
+std::map<std::string, double> lerMelhoresConhecidos(const fs::path& caminho) {
+    std::map<std::string, double> melhores;
+    if (caminho.empty()) return melhores;
+    std::ifstream arq(caminho);
+    if (!arq.is_open()) throw std::runtime_error("Erro ao abrir " + caminho.string());
+    std::string linha;
+    while (std::getline(arq, linha)) {
+        size_t sep = linha.find(';');
+        if (linha.empty() || linha[0] == '#' || sep == std::string::npos) continue;
+        melhores[linha.substr(0, sep)] = std::stod(linha.substr(sep + 1));
+    }
+    return melhores;
+}
+
+int benchmarkEstatistico(const ConfigEstatistica& cfg, const Parametros& params) {
+    std::map<std::string, double> melhores = lerMelhoresConhecidos(cfg.melhoresConhecidos);
+    fs::create_directories(cfg.saida / "trajetorias");
+    std::ofstream jsonl(cfg.saida / "execucoes.jsonl");
+    std::ofstream csv(cfg.saida / "execucoes.csv");
+    csv << "instancia;algoritmo;repeticao;semente;objetivo;lucro;penalidade;peso;tempoMs;avaliacoes;tempoAteMelhorMs;trajetoria\n";
+
+    std::vector<fs::path> caminhos;
+    for (const auto& entry : fs::recursive_directory_iterator(cfg.instancias)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".txt") continue;
+        if (entry.path().filename() == "readme.txt") continue;
+        caminhos.push_back(entry.path());
+    }
+    std::sort(caminhos.begin(), caminhos.end());
+
+    std::vector<Execucao> execucoes;
+    std::map<std::string, Caracteristicas> caracteristicas;
+    for (const auto& caminho : caminhos) {
+        std::string nome = fs::relative(caminho, cfg.instancias).generic_string();
+        Instance inst;
+        try {
+            inst = lerInstancia(caminho.string());
+            if (cfg.renumerar) renumerarItens(inst);   // Só as métricas são registradas: não há o que traduzir
+        } catch (const std::exception& e) {
+            std::cerr << "Erro ao processar " << caminho << ": " << e.what() << "\n";
+            continue;
+        }
+        caracteristicas[nome] = extrairCaracteristicas(inst);
+        for (const auto& algoritmo : cfg.algoritmos) {
+            for (int r = 0; r < cfg.repeticoes; ++r) {
+                // Mesmas sementes para todos os algoritmos (números aleatórios comuns)
+                Execucao ex{nome, algoritmo, "", r, Resultado()};
+                definirSemente(cfg.sementeBase + r);
+                auto start = std::chrono::steady_clock::now();
+                ex.res = executarSolver(algoritmo, inst, "", params);
+                ex.res.tempoMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+                std::string base = nome;
+                std::replace(base.begin(), base.end(), '/', '_');
+                ex.trajetoria = (fs::path("trajetorias") / (fs::path(base).stem().string() + "_" + algoritmo + "_" + std::to_string(r) + ".csv")).generic_string();
+                std::ofstream traj(cfg.saida / ex.trajetoria);
+                traj << "tempoMs;objetivo;avaliacoes\n";
+                for (const auto& p : ex.res.trajetoria) traj << p.tempoMs << ";" << p.objetivo << ";" << p.avaliacoes << "\n";
+
+                const Resultado& res = ex.res;
+                jsonl << "{\"instancia\":\"" << escaparJson(nome) << "\",\"algoritmo\":\"" << algoritmo
+                      << "\",\"repeticao\":" << r << ",\"semente\":" << res.semente
+                      << ",\"objetivo\":" << res.valorObjetivo << ",\"lucro\":" << res.lucroTotal
+                      << ",\"penalidade\":" << res.penalidadeTotal << ",\"peso\":" << res.pesoTotal
+                      << ",\"tempoMs\":" << res.tempoMs << ",\"avaliacoes\":" << res.avaliacoes
+                      << ",\"tempoAteMelhorMs\":" << res.tempoAteMelhorMs
+                      << ",\"trajetoria\":\"" << escaparJson(ex.trajetoria) << "\"}" << std::endl;
+                csv << nome << ";" << algoritmo << ";" << r << ";" << res.semente << ";" << res.valorObjetivo << ";"
+                    << res.lucroTotal << ";" << res.penalidadeTotal << ";" << res.pesoTotal << ";" << res.tempoMs << ";"
+                    << res.avaliacoes << ";" << res.tempoAteMelhorMs << ";" << ex.trajetoria << std::endl;
+
+                std::cout << nome << " " << algoritmo << " #" << r << ": " << res.valorObjetivo
+                          << " (" << res.tempoMs << " ms)\n";
+                ex.res.itensSelecionados.clear();   // Só as métricas são agregadas
+                execucoes.push_back(std::move(ex));
+            }
+        }
+    }
+
+    // Melhor conhecido: do arquivo, ou o melhor observado entre todos os algoritmos
+    std::map<std::string, double> doArquivo = melhores;
+    for (const auto& ex : execucoes) {
+        if (doArquivo.count(ex.instancia)) continue;
+        auto it = melhores.find(ex.instancia);
+        if (it == melhores.end() || ex.res.valorObjetivo > it->second) melhores[ex.instancia] = ex.res.valorObjetivo;
+    }
+
+    std::map<std::pair<std::string, std::string>, std::vector<const Execucao*>> grupos;
+    for (const auto& ex : execucoes) grupos[{ex.instancia, ex.algoritmo}].push_back(&ex);
+
+    std::ofstream resumo(cfg.saida / "resumo.csv");
+    resumo << "instancia;algoritmo;execucoes;media;mediana;desvio;melhor;pior;melhorConhecido;gapMedio;gapMelhor;"
+              "tempoMedioMs;tempoAteMelhorMedioMs;avaliacoesMedias;taxaAlvo\n";
+    std::map<std::string, AmostraSelecao> amostras;   // Por instância, para --gerar-regras
+    std::ofstream ttt(cfg.saida / "ttt.csv");
+    ttt << "instancia;algoritmo;alvo;ordem;tempoMs;probabilidade\n";
+
+    std::cout << "\n" << std::left << std::setw(40) << "instancia" << std::setw(9) << "algoritmo"
+              << std::right << std::setw(12) << "media" << std::setw(12) << "mediana" << std::setw(12) << "melhor"
+              << std::setw(10) << "gap%" << std::setw(12) << "tempo(ms)" << std::setw(8) << "alvo" << "\n";
+    for (const auto& [chave, grupo] : grupos) {
+        double melhorConhecido = melhores[chave.first];
+        // Alvo do TTT: fração do melhor conhecido, sem ultrapassá-lo
+        double alvo = melhorConhecido > 0 ? std::ceil(cfg.fracaoAlvo * melhorConhecido) : melhorConhecido;
+
+        std::vector<double> objetivos, tempos;
+        double soma = 0, somaTempo = 0, somaTtb = 0, somaAval = 0;
+        std::vector<double> temposAlvo;
+        for (const Execucao* ex : grupo) {
+            const Resultado& res = ex->res;
+            objetivos.push_back(res.valorObjetivo);
+            soma += res.valorObjetivo;
+            somaTempo += res.tempoMs;
+            somaTtb += res.tempoAteMelhorMs;
+            somaAval += res.avaliacoes;
+            // Tempo até o alvo: primeiro ponto da trajetória que o atinge (execução censurada se nunca)
+            for (const auto& p : res.trajetoria) {
+                if (p.objetivo >= alvo) {
+                    temposAlvo.push_back(p.tempoMs);
+                    break;
+                }
+            }
+        }
+        std::sort(objetivos.begin(), objetivos.end());
+        std::sort(temposAlvo.begin(), temposAlvo.end());
+        size_t R = grupo.size();
+        double media = soma / R;
+        double variancia = 0;
+        for (double v : objetivos) variancia += (v - media) * (v - media);
+        double desvio = R > 1 ? std::sqrt(variancia / (R - 1)) : 0.0;
+
+        resumo << chave.first << ";" << chave.second << ";" << R << ";" << media << ";" << quantil(objetivos, 0.5) << ";"
+               << desvio << ";" << objetivos.back() << ";" << objetivos.front() << ";" << melhorConhecido << ";"
+               << gapPercentual(media, melhorConhecido) << ";" << gapPercentual(objetivos.back(), melhorConhecido) << ";"
+               << somaTempo / R << ";" << somaTtb / R << ";" << somaAval / R << ";"
+               << (double)temposAlvo.size() / R << "\n";
+
+        if (chave.second != "auto") {
+            AmostraSelecao& a = amostras[chave.first];
+            a.caracteristicas = caracteristicas[chave.first];
+            a.custo[chave.second] = gapPercentual(media, melhorConhecido) + cfg.pesoTempo * somaTempo / R / 1000.0;
+        }
+
+        // Distribuição empírica do TTT: p_i = (i - 1/2) / R sobre as R execuções
+        for (size_t i = 0; i < temposAlvo.size(); ++i) {
+            ttt << chave.first << ";" << chave.second << ";" << alvo << ";" << i + 1 << ";" << temposAlvo[i] << ";"
+                << (i + 0.5) / R << "\n";
+        }
+
+        std::cout << std::left << std::setw(40) << chave.first << std::setw(9) << chave.second << std::right
+                  << std::setw(12) << media << std::setw(12) << quantil(objetivos, 0.5) << std::setw(12) << objetivos.back()
+                  << std::setw(10) << std::setprecision(3) << gapPercentual(media, melhorConhecido) << std::setprecision(6)
+                  << std::setw(12) << somaTempo / R << std::setw(5) << temposAlvo.size() << "/" << R << "\n";
+    }
+
+    std::cout << "\nRegistros em " << cfg.saida << " (execucoes.jsonl, execucoes.csv, resumo.csv, ttt.csv, trajetorias/)\n";
+
+    if (!cfg.regrasSaida.empty()) {
+        std::vector<AmostraSelecao> lista;
+        for (const auto& [nome, a] : amostras) lista.push_back(a);
+        std::vector<RegraAuto> regras = gerarRegras(lista);
+        std::stringstream cabecalho;
+        cabecalho << "# Regras do modo auto geradas por main_b.out a partir de " << lista.size() << " instancias, "
+                  << cfg.repeticoes << " repeticoes.\n# Custo = gap% medio + " << cfg.pesoTempo
+                  << " x tempo medio (s). Vale a primeira regra que atender.\n";
+        salvarRegras(cfg.regrasSaida, regras, cabecalho.str());
+        std::cout << "Regras do modo auto gravadas em " << cfg.regrasSaida << " (" << regras.size() << " regras)\n";
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    Parametros params = parametrosPadrao();
+    ConfigEstatistica cfg;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--renumerar") {
+            cfg.renumerar = true;
+            continue;
+        }
+        if (i + 1 >= argc) break;
+        if (arg == "--threads") definirOrcamentoThreads(std::stoi(argv[++i]));
+        else if (arg == "--params") {
+            try {
+                carregarParametros(argv[++i], params);
+            } catch (const std::exception& e) {
+                std::cerr << "Erro: " << e.what() << "\n";
+                return 1;
+            }
+        }
+        else if (arg == "--repeticoes") cfg.repeticoes = std::stoi(argv[++i]);
+        else if (arg == "--semente") cfg.sementeBase = std::stoul(argv[++i]);
+        else if (arg == "--instancias") cfg.instancias = argv[++i];
+        else if (arg == "--saida-dados") cfg.saida = argv[++i];
+        else if (arg == "--melhores") cfg.melhoresConhecidos = argv[++i];
+        else if (arg == "--alvo") cfg.fracaoAlvo = std::stod(argv[++i]);
+        else if (arg == "--gerar-regras") cfg.regrasSaida = argv[++i];
+        else if (arg == "--peso-tempo") cfg.pesoTempo = std::stod(argv[++i]);
+        else if (arg == "--regras") {
+            try {
+                definirRegrasAuto(carregarRegras(argv[++i]));
+            } catch (const std::exception& e) {
+                std::cerr << "Erro: " << e.what() << "\n";
+                return 1;
+            }
+        }
+        else if (arg == "--algoritmos") {
+            cfg.algoritmos.clear();
+            std::stringstream lista(argv[++i]);
+            std::string nome;
+            while (std::getline(lista, nome, ',')) cfg.algoritmos.push_back(nome);
+        }
+    }
+    if (cfg.repeticoes > 0) {
+        try {
+            return benchmarkEstatistico(cfg, params);
+        } catch (const std::exception& e) {
+            std::cerr << "Erro: " << e.what() << "\n";
+            return 1;
+        }
+    }
+
     std::string algoritmo;
     std::cout << "Selecione o algoritmo:\n";
     std::cout << "1 - GRASP\n";
     std::cout << "2 - VNS\n";
     std::cout << "3 - Tabu Search\n";
     std::cout << "4 - Genetic Algorithm\n";
+    std::cout << "5 - LNS\n";
+    std::cout << "6 - Guloso (heap de valores marginais)\n";
+    std::cout << "7 - Portfolio (GRASP + VNS + Tabu + GA em paralelo)\n";
+    std::cout << "8 - Tempera paralela (recozimento simulado com troca de replicas)\n";
+    std::cout << "9 - Automatico (escolhe o solver pelas caracteristicas da instancia)\n";
+    std::cout << "10 - Branch-and-bound exato (paralelo, com roubo de trabalho)\n";
     std::cout << ">> ";
     int opcao;
     std::cin >> opcao;
@@ -60,6 +339,12 @@ int main() {
         case 2: algoritmo = "vns"; break;
         case 3: algoritmo = "tabu"; break;
         case 4: algoritmo = "genetic"; break;
+        case 5: algoritmo = "lns"; break;
+        case 6: algoritmo = "guloso"; break;
+        case 7: algoritmo = "portfolio"; break;
+        case 8: algoritmo = "tempera"; break;
+        case 9: algoritmo = "auto"; break;
+        case 10: algoritmo = "exato"; break;
         default:
             std::cerr << "Opção inválida.\n";
             return 1;
@@ -81,21 +366,19 @@ int main() {
 
         try {
             Instance inst = lerInstancia(caminhoInstancia.string());
+            Renumeracao renumeracao;
+            if (cfg.renumerar) renumeracao = renumerarItens(inst);
             fs::path caminhoOutput = gerarCaminhoOutput(caminhoInstancia, algoritmo);
             fs::create_directories(caminhoOutput.parent_path());
 
             auto start = std::chrono::high_resolution_clock::now();
 
-            Resultado res;
-            if (algoritmo == "grasp") res = grasp(inst, caminhoOutput);
-            else if (algoritmo == "vns") res = vns(inst,caminhoOutput);
-            else if (algoritmo == "tabu") res = tabu_search(inst, caminhoOutput);
-            else if (algoritmo == "genetic") res = genetic_algorithm(inst,caminhoOutput);
+            Resultado res = executarSolver(algoritmo, inst, caminhoOutput, params);
 
             auto end = std::chrono::high_resolution_clock::now();
             res.tempoMs = std::chrono::duration<double, std::milli>(end - start).count();
+            if (cfg.renumerar) restaurarNumeracao(res, renumeracao);
 
-            
             salvarResultado(caminhoOutput, res, inst);
         }
         catch (const std::exception& e) {
@@ -0,0 +1,255 @@
+#include <iostream>
+#include <filesystem>
+#include <string>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+#include <omp.h>
+
+#include "utils/structs.hpp"
+#include "utils/interpreter.hpp"
+#include "algorithms/solvers.cpp"
+
+namespace fs = std::filesystem;
+
+// Ajuste de hiperparâmetros por corrida (F-race): configurações candidatas são avaliadas
+// instância a instância (blocos); após alguns blocos, o teste de Friedman e o pós-teste de
+// Conover eliminam as candidatas estatisticamente piores. As execuções de um bloco rodam em
+// paralelo, uma por thread (cada solver com orçamento de 1 thread).
+
+struct Candidato {
+    Parametros params;
+    std::vector<double> objetivos;   // Um valor por bloco
+    bool viva = true;
+};
+
+// Postos de um bloco (1 = maior objetivo), com a média dos postos em caso de empate.
+std::vector<double> postosBloco(const std::vector<double>& valores) {
+    std::vector<int> ordem(valores.size());
+    std::iota(ordem.begin(), ordem.end(), 0);
+    std::sort(ordem.begin(), ordem.end(), [&](int a, int b) { return valores[a] > valores[b]; });
+    std::vector<double> postos(valores.size());
+    for (size_t i = 0; i < ordem.size();) {
+        size_t j = i;
+        while (j + 1 < ordem.size() && valores[ordem[j + 1]] == valores[ordem[i]]) ++j;
+        double medio = (i + j) / 2.0 + 1.0;
+        for (size_t t = i; t <= j; ++t) postos[ordem[t]] = medio;
+        i = j + 1;
+    }
+    return postos;
+}
+
+// Quantil 0.95 da qui-quadrado com 'gl' graus de liberdade (aproximação de Wilson-Hilferty).
+double quiQuadrado95(int gl) {
+    const double z = 1.6448536;
+    double a = 2.0 / (9.0 * gl);
+    return gl * std::pow(1.0 - a + z * std::sqrt(a), 3);
+}
+
+// Quantil 0.975 da t de Student com 'gl' graus de liberdade (expansão de Cornish-Fisher).
+double tStudent975(int gl) {
+    const double z = 1.959964;
+    double z3 = z * z * z, z5 = z3 * z * z;
+    return z + (z3 + z) / (4.0 * gl) + (5 * z5 + 16 * z3 + 3 * z) / (96.0 * gl * gl);
+}
+
+/**
+ * @brief Teste de Friedman sobre as candidatas vivas; se significativo, descarta as que
+ *        diferem da melhor pelo pós-teste de Conover (como no F-race de Birattari et al.).
+ * @return Número de candidatas descartadas.
+ */
+int eliminarPiores(std::vector<Candidato>& candidatos) {
+    std::vector<int> vivas;
+    for (size_t c = 0; c < candidatos.size(); ++c) if (candidatos[c].viva) vivas.push_back(c);
+    int k = vivas.size();
+    int b = candidatos[vivas[0]].objetivos.size();
+    if (k < 2 || b < 2) return 0;
+
+    std::vector<double> somaPostos(k, 0.0);
+    double somaQuadrados = 0.0;
+    for (int bloco = 0; bloco < b; ++bloco) {
+        std::vector<double> valores(k);
+        for (int c = 0; c < k; ++c) valores[c] = candidatos[vivas[c]].objetivos[bloco];
+        std::vector<double> postos = postosBloco(valores);
+        for (int c = 0; c < k; ++c) {
+            somaPostos[c] += postos[c];
+            somaQuadrados += postos[c] * postos[c];
+        }
+    }
+
+    double correcao = b * k * (k + 1) * (k + 1) / 4.0;
+    double denominador = somaQuadrados - correcao;
+    if (denominador <= 1e-12) return 0;   // Todas empatadas em todos os blocos
+
+    double T = 0.0;
+    for (int c = 0; c < k; ++c) {
+        double d = somaPostos[c] - b * (k + 1) / 2.0;
+        T += d * d;
+    }
+    T *= (k - 1) / denominador;
+    if (T <= quiQuadrado95(k - 1)) return 0;
+
+    int melhor = std::min_element(somaPostos.begin(), somaPostos.end()) - somaPostos.begin();
+    double escala = std::sqrt(2.0 * b * (1.0 - T / (b * (k - 1.0))) * denominador / ((b - 1.0) * (k - 1.0)));
+    double critico = tStudent975((b - 1) * (k - 1)) * escala;
+
+    int descartadas = 0;
+    for (int c = 0; c < k; ++c) {
+        if (c != melhor && somaPostos[c] - somaPostos[melhor] > critico) {
+            candidatos[vivas[c]].viva = false;
+            descartadas++;
+        }
+    }
+    return descartadas;
+}
+
+// Sorteia uma configuração no intervalo de cada parâmetro do algoritmo.
+Parametros sortearCandidato(const Parametros& base, const std::string& algoritmo, std::mt19937& rng) {
+    Parametros p = base;
+    for (const auto& e : especParametrosDe(algoritmo)) {
+        double v = std::uniform_real_distribution<double>(e.minimo, e.maximo)(rng);
+        p[e.nome] = e.inteiro ? std::round(v) : v;
+    }
+    return p;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Uso: " << argv[0] << " <algoritmo> <diretorio_treino> [--orcamento-seg S] [--candidatos N]"
+                  << " [--min-blocos N] [--max-blocos N] [--saida arquivo.cfg] [--params base.cfg]"
+                  << " [--threads N] [--semente S]\n";
+        std::cerr << "Algoritmos: grasp, vns, tabu, genetic, lns\n";
+        return 1;
+    }
+    std::string algoritmo = argv[1];
+    fs::path diretorio = argv[2];
+    double orcamentoSeg = 600.0;
+    int numCandidatos = 16;
+    int minBlocos = 5;
+    int maxBlocos = 50;
+    int threads = omp_get_max_threads();
+    unsigned semente = std::random_device{}();
+    fs::path saida = fs::path("config") / (algoritmo + "_tuned.cfg");
+    Parametros base = parametrosPadrao();
+
+    try {
+        for (int i = 3; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) break;
+            if (arg == "--orcamento-seg") orcamentoSeg = std::stod(argv[++i]);
+            else if (arg == "--candidatos") numCandidatos = std::max(2, std::stoi(argv[++i]));
+            else if (arg == "--min-blocos") minBlocos = std::max(2, std::stoi(argv[++i]));
+            else if (arg == "--max-blocos") maxBlocos = std::stoi(argv[++i]);
+            else if (arg == "--saida") saida = argv[++i];
+            else if (arg == "--params") carregarParametros(argv[++i], base);
+            else if (arg == "--threads") threads = std::max(1, std::stoi(argv[++i]));
+            else if (arg == "--semente") semente = std::stoul(argv[++i]);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Erro: " << e.what() << "\n";
+        return 1;
+    }
+    if (especParametrosDe(algoritmo).empty()) {
+        std::cerr << "Algoritmo sem parametros ajustaveis: " << algoritmo << "\n";
+        return 1;
+    }
+
+    // Conjunto de treino
+    std::vector<fs::path> treino;
+    for (const auto& entry : fs::recursive_directory_iterator(diretorio)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".txt") continue;
+        if (entry.path().filename() == "readme.txt") continue;
+        treino.push_back(entry.path());
+    }
+    if (treino.empty()) {
+        std::cerr << "Nenhuma instancia em " << diretorio << "\n";
+        return 1;
+    }
+    std::mt19937 rng(semente);
+    std::shuffle(treino.begin(), treino.end(), rng);
+
+    // Candidatas: a configuração base e sorteios uniformes nos intervalos
+    std::vector<Candidato> candidatos(numCandidatos);
+    candidatos[0].params = base;
+    for (int c = 1; c < numCandidatos; ++c) candidatos[c].params = sortearCandidato(base, algoritmo, rng);
+
+    std::cout << "F-race: " << algoritmo << ", " << numCandidatos << " candidatas, " << treino.size()
+              << " instancias, " << threads << " threads, orcamento " << orcamentoSeg << " s, semente " << semente << "\n";
+
+    auto inicio = std::chrono::steady_clock::now();
+    auto decorrido = [&]() { return std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count(); };
+
+    int bloco = 0;
+    int vivas = numCandidatos;
+    double tempoUltimoBloco = 0.0;
+    while (bloco < maxBlocos && vivas > 1 && decorrido() + tempoUltimoBloco <= orcamentoSeg) {
+        const fs::path& caminho = treino[bloco % treino.size()];
+        Instance inst;
+        try {
+            inst = lerInstancia(caminho.string());
+        } catch (const std::exception& e) {
+            std::cerr << "Erro ao ler " << caminho << ": " << e.what() << "\n";
+            return 1;
+        }
+
+        std::vector<int> ativos;
+        for (int c = 0; c < numCandidatos; ++c) if (candidatos[c].viva) ativos.push_back(c);
+        std::vector<double> objetivos(ativos.size());
+
+        double inicioBloco = decorrido();
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(threads)
+        for (int t = 0; t < (int)ativos.size(); ++t) {
+            definirOrcamentoThreads(1);
+            try {
+                objetivos[t] = executarSolver(algoritmo, inst, "", candidatos[ativos[t]].params).valorObjetivo;
+            } catch (const std::exception& e) {
+                objetivos[t] = -1e18;   // Configuração que falha perde o bloco
+            }
+        }
+        tempoUltimoBloco = decorrido() - inicioBloco;
+
+        for (size_t t = 0; t < ativos.size(); ++t) candidatos[ativos[t]].objetivos.push_back(objetivos[t]);
+        bloco++;
+
+        int descartadas = bloco >= minBlocos ? eliminarPiores(candidatos) : 0;
+        vivas -= descartadas;
+        std::cout << "Bloco " << bloco << " (" << caminho.filename().string() << "): " << ativos.size()
+                  << " execucoes em " << tempoUltimoBloco << " s, " << descartadas << " descartadas, "
+                  << vivas << " vivas\n";
+    }
+
+    // Vencedora: menor posto médio entre as vivas
+    int vencedora = -1;
+    double melhorPosto = 1e18;
+    std::vector<int> ativos;
+    for (int c = 0; c < numCandidatos; ++c) if (candidatos[c].viva) ativos.push_back(c);
+    std::vector<double> somaPostos(ativos.size(), 0.0);
+    for (int b = 0; b < bloco; ++b) {
+        std::vector<double> valores(ativos.size());
+        for (size_t t = 0; t < ativos.size(); ++t) valores[t] = candidatos[ativos[t]].objetivos[b];
+        std::vector<double> postos = postosBloco(valores);
+        for (size_t t = 0; t < ativos.size(); ++t) somaPostos[t] += postos[t];
+    }
+    for (size_t t = 0; t < ativos.size(); ++t) {
+        if (somaPostos[t] < melhorPosto) {
+            melhorPosto = somaPostos[t];
+            vencedora = ativos[t];
+        }
+    }
+
+    std::ostringstream resumo;
+    resumo << "F-race " << algoritmo << ": " << bloco << " blocos, " << ativos.size() << " sobreviventes de "
+           << numCandidatos << ", posto medio " << (bloco > 0 ? melhorPosto / bloco : 0.0)
+           << ", " << decorrido() << " s, semente " << semente << "\n"
+           << "Carregar com: --params " << saida.string();
+    salvarParametros(saida, candidatos[vencedora].params, algoritmo, resumo.str());
+
+    std::cout << "\n" << resumo.str() << "\n";
+    for (const auto& e : especParametrosDe(algoritmo)) {
+        std::cout << "  " << e.nome << "=" << candidatos[vencedora].params.at(e.nome) << "\n";
+    }
+    return 0;
+}
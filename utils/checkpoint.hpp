@@ -0,0 +1,301 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "structs.hpp"
+#include "estado.hpp"
+#include "registro.hpp"
+#include "rastreio.hpp"
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+// Checkpoint binário do estado de um solver (GA, TS, VNS), para retomar execuções longas.
+// Arquivo: cabeçalho (assinatura, versão, algoritmo, impressão digital da instância, tamanho
+// e soma de verificação do conteúdo) seguido do conteúdo gravado pelo solver. A gravação é
+// atômica: escreve em "<arquivo>.tmp", sincroniza com o disco e renomeia por cima do anterior,
+// de modo que uma interrupção no meio deixa intacto o último checkpoint completo.
+
+const char ASSINATURA_CHECKPOINT[8] = {'K', 'P', 'F', 'S', 'C', 'K', 'P', 'T'};
+const uint32_t VERSAO_CHECKPOINT = 1;
+
+// Configuração definida pelo chamador (thread_local, como o orçamento de threads e a semente).
+// Cada solver a lê uma vez, antes de abrir sua região paralela.
+struct ConfigCheckpoint {
+    std::filesystem::path arquivo;    // Vazio = sem checkpoints
+    double intervaloSeg = 300.0;
+    std::filesystem::path retomar;    // Vazio = execução nova
+};
+thread_local ConfigCheckpoint configCheckpoint;
+
+void definirCheckpoint(const std::filesystem::path& arquivo, double intervaloSeg) {
+    configCheckpoint.arquivo = arquivo;
+    configCheckpoint.intervaloSeg = intervaloSeg;
+}
+
+void definirRetomada(const std::filesystem::path& arquivo) {
+    configCheckpoint.retomar = arquivo;
+}
+
+// FNV-1a de 64 bits.
+uint64_t hashBytes(const void* dados, size_t n, uint64_t h = 1469598103934665603ULL) {
+    const unsigned char* p = static_cast<const unsigned char*>(dados);
+    for (size_t i = 0; i < n; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// Impressão digital da instância: impede retomar um checkpoint em outra instância.
+uint64_t impressaoDigital(const Instance& inst) {
+    uint64_t h = hashBytes(&inst.numItems, sizeof(inst.numItems));
+    h = hashBytes(&inst.numSets, sizeof(inst.numSets), h);
+    h = hashBytes(&inst.capacity, sizeof(inst.capacity), h);
+    h = hashBytes(inst.profits.data(), inst.profits.size() * sizeof(int), h);
+    h = hashBytes(inst.weights.data(), inst.weights.size() * sizeof(int), h);
+    for (const auto& fs : inst.forfeitSets) {
+        h = hashBytes(&fs.nA, sizeof(fs.nA), h);
+        h = hashBytes(&fs.forfeitCost, sizeof(fs.forfeitCost), h);
+        h = hashBytes(fs.items.data(), fs.items.size() * sizeof(int), h);
+    }
+    return h;
+}
+
+// Serialização em memória (valores triviais, vetores, vetores de bits empacotados e geradores).
+struct GravadorBinario {
+    std::string dados;
+
+    template <typename T>
+    void valor(const T& v) {
+        static_assert(std::is_trivially_copyable<T>::value, "tipo nao serializavel");
+        dados.append(reinterpret_cast<const char*>(&v), sizeof(T));
+    }
+
+    template <typename T>
+    void vetor(const std::vector<T>& v) {
+        valor<uint64_t>(v.size());
+        dados.append(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+    }
+
+    void bits(const std::vector<bool>& v) {
+        valor<uint64_t>(v.size());
+        std::string bytes((v.size() + 7) / 8, '\0');
+        for (size_t i = 0; i < v.size(); ++i) if (v[i]) bytes[i / 8] |= 1 << (i % 8);
+        dados += bytes;
+    }
+
+    void texto(const std::string& s) {
+        valor<uint64_t>(s.size());
+        dados += s;
+    }
+
+    // Estado completo de um gerador <random> (formato textual padrão da biblioteca).
+    template <typename G>
+    void gerador(const G& g) {
+        std::ostringstream out;
+        out << g;
+        texto(out.str());
+    }
+};
+
+struct LeitorBinario {
+    std::string dados;
+    size_t pos = 0;
+
+    void exigir(size_t n) {
+        if (pos + n > dados.size()) throw std::runtime_error("Checkpoint truncado");
+    }
+
+    template <typename T>
+    T valor() {
+        static_assert(std::is_trivially_copyable<T>::value, "tipo nao serializavel");
+        exigir(sizeof(T));
+        T v;
+        std::memcpy(&v, dados.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return v;
+    }
+
+    template <typename T>
+    std::vector<T> vetor() {
+        uint64_t n = valor<uint64_t>();
+        exigir(n * sizeof(T));
+        std::vector<T> v(n);
+        std::memcpy(v.data(), dados.data() + pos, n * sizeof(T));
+        pos += n * sizeof(T);
+        return v;
+    }
+
+    std::vector<bool> bits() {
+        uint64_t n = valor<uint64_t>();
+        exigir((n + 7) / 8);
+        std::vector<bool> v(n);
+        for (size_t i = 0; i < n; ++i) v[i] = (dados[pos + i / 8] >> (i % 8)) & 1;
+        pos += (n + 7) / 8;
+        return v;
+    }
+
+    std::string texto() {
+        uint64_t n = valor<uint64_t>();
+        exigir(n);
+        std::string s = dados.substr(pos, n);
+        pos += n;
+        return s;
+    }
+
+    template <typename G>
+    void gerador(G& g) {
+        std::istringstream in(texto());
+        in >> g;
+        if (in.fail()) throw std::runtime_error("Checkpoint com gerador invalido");
+    }
+};
+
+void gravarEstado(GravadorBinario& g, const EstadoSolucao& e) {
+    g.vetor(e.x);
+    g.vetor(e.contagem);
+    g.valor(e.lucro);
+    g.valor(e.peso);
+    g.valor(e.penalidade);
+}
+
+EstadoSolucao lerEstado(LeitorBinario& l, const Instance& inst) {
+    EstadoSolucao e;
+    e.x = l.vetor<unsigned char>();
+    e.contagem = l.vetor<int>();
+    e.lucro = l.valor<long long>();
+    e.peso = l.valor<long long>();
+    e.penalidade = l.valor<long long>();
+    if (e.x.size() != static_cast<size_t>(inst.numItems) || e.contagem.size() != static_cast<size_t>(inst.numSets)) {
+        throw std::runtime_error("Checkpoint com estado de tamanho invalido");
+    }
+    indexarViolados(e, inst);
+    return e;
+}
+
+// Métricas da execução: a retomada continua contando tempo, avaliações e trajetória.
+void gravarRegistro(GravadorBinario& g, const RegistroExecucao& r) {
+    g.valor(r.semente);
+    g.valor(r.decorridoMs());
+    g.valor(r.avaliacoes.load());
+    g.vetor(r.trajetoria);
+}
+
+void lerRegistro(LeitorBinario& l, RegistroExecucao& r) {
+    r.semente = l.valor<unsigned>();
+    r.deslocamentoMs = l.valor<double>();
+    r.inicio = std::chrono::steady_clock::now();
+    r.avaliacoes = l.valor<long long>();
+    r.trajetoria = l.vetor<PontoTrajetoria>();
+}
+
+/**
+ * @brief Grava o checkpoint de forma atômica (arquivo temporário + fsync + rename).
+ * @param algoritmo Nome do solver (o mesmo aceito por executarSolver).
+ */
+void salvarCheckpoint(const std::filesystem::path& arquivo, const std::string& algoritmo,
+                      const Instance& inst, const GravadorBinario& conteudo) {
+    EscopoRastreio io("checkpoint", "io");
+    GravadorBinario cab;
+    cab.dados.append(ASSINATURA_CHECKPOINT, sizeof(ASSINATURA_CHECKPOINT));
+    cab.valor(VERSAO_CHECKPOINT);
+    cab.texto(algoritmo);
+    cab.valor(impressaoDigital(inst));
+    cab.valor<uint64_t>(conteudo.dados.size());
+    cab.valor(hashBytes(conteudo.dados.data(), conteudo.dados.size()));
+
+    if (arquivo.has_parent_path()) std::filesystem::create_directories(arquivo.parent_path());
+    std::filesystem::path temporario = arquivo;
+    temporario += ".tmp";
+    FILE* f = std::fopen(temporario.string().c_str(), "wb");
+    if (!f) throw std::runtime_error("Erro ao gravar checkpoint: " + temporario.string());
+    bool ok = std::fwrite(cab.dados.data(), 1, cab.dados.size(), f) == cab.dados.size() &&
+              std::fwrite(conteudo.dados.data(), 1, conteudo.dados.size(), f) == conteudo.dados.size() &&
+              std::fflush(f) == 0;
+#if defined(__unix__) || defined(__APPLE__)
+    ok = ok && fsync(fileno(f)) == 0;
+#endif
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok) throw std::runtime_error("Erro ao gravar checkpoint: " + temporario.string());
+    std::filesystem::rename(temporario, arquivo);
+}
+
+// Lê e valida o cabeçalho; devolve o leitor posicionado no conteúdo.
+LeitorBinario abrirCheckpoint(const std::filesystem::path& arquivo, std::string& algoritmo, uint64_t& digital) {
+    std::ifstream in(arquivo, std::ios::binary);
+    if (!in.is_open()) throw std::runtime_error("Erro ao abrir checkpoint: " + arquivo.string());
+    LeitorBinario l;
+    l.dados.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+    l.exigir(sizeof(ASSINATURA_CHECKPOINT));
+    if (std::memcmp(l.dados.data(), ASSINATURA_CHECKPOINT, sizeof(ASSINATURA_CHECKPOINT)) != 0) {
+        throw std::runtime_error("Arquivo nao e um checkpoint: " + arquivo.string());
+    }
+    l.pos = sizeof(ASSINATURA_CHECKPOINT);
+    if (l.valor<uint32_t>() != VERSAO_CHECKPOINT) throw std::runtime_error("Versao de checkpoint incompativel");
+    algoritmo = l.texto();
+    digital = l.valor<uint64_t>();
+    uint64_t tamanho = l.valor<uint64_t>();
+    uint64_t soma = l.valor<uint64_t>();
+    if (l.dados.size() - l.pos != tamanho || hashBytes(l.dados.data() + l.pos, tamanho) != soma) {
+        throw std::runtime_error("Checkpoint corrompido: " + arquivo.string());
+    }
+    return l;
+}
+
+// Nome do solver que gravou o checkpoint (usado pela retomada para escolher o algoritmo).
+std::string algoritmoDoCheckpoint(const std::filesystem::path& arquivo) {
+    std::string algoritmo;
+    uint64_t digital;
+    abrirCheckpoint(arquivo, algoritmo, digital);
+    return algoritmo;
+}
+
+// Abre o checkpoint para retomada, exigindo o mesmo solver e a mesma instância.
+LeitorBinario carregarCheckpoint(const std::filesystem::path& arquivo, const std::string& algoritmo,
+                                 const Instance& inst) {
+    std::string gravado;
+    uint64_t digital;
+    LeitorBinario l = abrirCheckpoint(arquivo, gravado, digital);
+    if (gravado != algoritmo) throw std::runtime_error("Checkpoint de outro algoritmo: " + gravado);
+    if (digital != impressaoDigital(inst)) throw std::runtime_error("Checkpoint de outra instancia");
+    return l;
+}
+
+// Confere se os hiperparâmetros da retomada são os mesmos da execução original.
+void conferirParametros(LeitorBinario& l, const std::vector<double>& parametros) {
+    if (l.vetor<double>() != parametros) {
+        throw std::runtime_error("Parametros diferentes dos usados na execucao do checkpoint");
+    }
+}
+
+// Agenda periódica: devido() consulta só o relógio, então pode ser chamada a cada iteração.
+struct AgendaCheckpoint {
+    ConfigCheckpoint config;
+    std::chrono::steady_clock::time_point proximo;
+
+    AgendaCheckpoint() : config(configCheckpoint) { adiar(); }
+
+    bool ativo() const { return !config.arquivo.empty(); }
+    bool retomando() const { return !config.retomar.empty(); }
+
+    void adiar() {
+        proximo = std::chrono::steady_clock::now() +
+                  std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(config.intervaloSeg));
+    }
+
+    bool devido() {
+        if (!ativo() || std::chrono::steady_clock::now() < proximo) return false;
+        adiar();
+        return true;
+    }
+};
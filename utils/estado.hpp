@@ -0,0 +1,141 @@
+#pragma once
+#include <vector>
+#include <stdexcept>
+#include "structs.hpp"
+
+// Estado incremental de uma solução: mantém lucro, peso, penalidade e a contagem de
+// itens selecionados por conjunto, de modo que avaliar ou aplicar um flip custe
+// O(número de conjuntos do item). Memória O(n + numSets); nada é alocado por vizinho.
+struct EstadoSolucao {
+    std::vector<unsigned char> x;   // 1 = item selecionado
+    std::vector<int> contagem;      // Itens selecionados em cada conjunto
+    long long lucro = 0;
+    long long peso = 0;
+    long long penalidade = 0;
+
+    // Conjuntos com contagem > nA, mantidos a cada flip: lista de candidatos dos movimentos
+    // compostos (utils/movimentos.hpp). posViolado[s] = posição em 'violados' ou -1.
+    std::vector<int> violados;
+    std::vector<int> posViolado;
+
+    long long objetivo() const { return lucro - penalidade; }
+};
+
+void marcarViolado(EstadoSolucao& e, int s) {
+    e.posViolado[s] = e.violados.size();
+    e.violados.push_back(s);
+}
+
+void desmarcarViolado(EstadoSolucao& e, int s) {
+    int pos = e.posViolado[s];
+    int ultimo = e.violados.back();
+    e.violados[pos] = ultimo;
+    e.posViolado[ultimo] = pos;
+    e.violados.pop_back();
+    e.posViolado[s] = -1;
+}
+
+// Reconstrói a lista de conjuntos violados a partir das contagens.
+void indexarViolados(EstadoSolucao& e, const Instance& inst) {
+    e.violados.clear();
+    e.posViolado.assign(inst.numSets, -1);
+    for (int s = 0; s < inst.numSets; ++s) {
+        if (e.contagem[s] > inst.forfeitSets[s].nA) marcarViolado(e, s);
+    }
+}
+
+EstadoSolucao criarEstado(const Instance& inst, const std::vector<bool>& sol) {
+    if (inst.numSets > 0 && inst.inicioConjuntosItem.size() != static_cast<size_t>(inst.numItems) + 1) {
+        throw std::runtime_error("Instancia sem indice item->conjuntos (chame indexarConjuntos)");
+    }
+    EstadoSolucao e;
+    e.x.assign(inst.numItems, 0);
+    e.contagem.assign(inst.numSets, 0);
+    for (int j = 0; j < inst.numItems; ++j) {
+        if (!sol[j]) continue;
+        e.x[j] = 1;
+        e.lucro += inst.profits[j];
+        e.peso += inst.weights[j];
+    }
+    for (int s = 0; s < inst.numSets; ++s) {
+        const auto& fs = inst.forfeitSets[s];
+        for (int item : fs.items) e.contagem[s] += e.x[item];
+        if (e.contagem[s] > fs.nA) e.penalidade += static_cast<long long>(e.contagem[s] - fs.nA) * fs.forfeitCost;
+    }
+    indexarViolados(e, inst);
+    return e;
+}
+
+EstadoSolucao criarEstadoVazio(const Instance& inst) {
+    return criarEstado(inst, std::vector<bool>(inst.numItems, false));
+}
+
+// Variação da penalidade ao inverter o item j.
+long long deltaPenalidadeFlip(const EstadoSolucao& e, const Instance& inst, int j) {
+    long long delta = 0;
+    bool adiciona = !e.x[j];
+    for (int k = inst.inicioConjuntosItem[j]; k < inst.inicioConjuntosItem[j + 1]; ++k) {
+        int s = inst.conjuntosDoItem[k];
+        const auto& fs = inst.forfeitSets[s];
+        if (adiciona) {
+            if (e.contagem[s] >= fs.nA) delta += fs.forfeitCost;
+        } else {
+            if (e.contagem[s] > fs.nA) delta -= fs.forfeitCost;
+        }
+    }
+    return delta;
+}
+
+long long deltaPesoFlip(const EstadoSolucao& e, const Instance& inst, int j) {
+    return e.x[j] ? -inst.weights[j] : inst.weights[j];
+}
+
+long long deltaObjetivoFlip(const EstadoSolucao& e, const Instance& inst, int j) {
+    long long deltaLucro = e.x[j] ? -inst.profits[j] : inst.profits[j];
+    return deltaLucro - deltaPenalidadeFlip(e, inst, j);
+}
+
+bool viavelAposFlip(const EstadoSolucao& e, const Instance& inst, int j) {
+    return e.peso + deltaPesoFlip(e, inst, j) <= inst.capacity;
+}
+
+void aplicarFlip(EstadoSolucao& e, const Instance& inst, int j) {
+    e.penalidade += deltaPenalidadeFlip(e, inst, j);
+    int sinal = e.x[j] ? -1 : 1;
+    e.lucro += sinal * inst.profits[j];
+    e.peso += sinal * inst.weights[j];
+    for (int k = inst.inicioConjuntosItem[j]; k < inst.inicioConjuntosItem[j + 1]; ++k) {
+        int c = inst.conjuntosDoItem[k];
+        int contagem = (e.contagem[c] += sinal);
+        int nA = inst.forfeitSets[c].nA;
+        if (sinal > 0 && contagem == nA + 1) marcarViolado(e, c);
+        else if (sinal < 0 && contagem == nA) desmarcarViolado(e, c);
+    }
+    e.x[j] ^= 1;
+}
+
+// Variação do objetivo ao trocar 'sai' (selecionado) por 'entra' (não selecionado).
+// Aplica e desfaz o primeiro flip, sem alocar memória.
+long long deltaObjetivoTroca(EstadoSolucao& e, const Instance& inst, int entra, int sai) {
+    long long antes = e.objetivo();
+    aplicarFlip(e, inst, sai);
+    long long delta = e.objetivo() - antes + deltaObjetivoFlip(e, inst, entra);
+    aplicarFlip(e, inst, sai);
+    return delta;
+}
+
+std::vector<bool> paraVetor(const EstadoSolucao& e) {
+    return std::vector<bool>(e.x.begin(), e.x.end());
+}
+
+// Preenche as métricas de um Resultado diretamente do estado (O(n) pela cópia da solução).
+Resultado resultadoDoEstado(const EstadoSolucao& e) {
+    Resultado res;
+    res.itensSelecionados = paraVetor(e);
+    res.lucroTotal = e.lucro;
+    res.pesoTotal = e.peso;
+    res.penalidadeTotal = e.penalidade;
+    res.valorObjetivo = e.objetivo();
+    res.tempoMs = 0.0;
+    return res;
+}
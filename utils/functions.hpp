@@ -7,16 +7,25 @@
 #include <cfloat>
 #include "structs.hpp"
 
+// Instâncias a partir deste tamanho rodam no modo de grande escala: vizinhanças
+// quadráticas são desligadas e a memória dos solvers fica em O(n + Σ|conjunto|).
+const int LIMIAR_GRANDE_ESCALA = 100000;
 
-int calcularPenalidade(const Instance& inst, const std::vector<bool>& selecionado) {
-    int total = 0;
+bool modoGrandeEscala(const Instance& inst) {
+    return inst.numItems >= LIMIAR_GRANDE_ESCALA;
+}
+
+// Penalidade de uma solução: cada item selecionado além de nA em um conjunto custa forfeitCost.
+// É a mesma regra usada por get_objective_value.
+long long calcularPenalidade(const Instance& inst, const std::vector<bool>& selecionado) {
+    long long total = 0;
 
     for (const auto& fs : inst.forfeitSets) {
         int count = 0;
         for (int item : fs.items) {
             if (selecionado[item]) count++;
         }
-        if (count > fs.nA) total += fs.forfeitCost;
+        if (count > fs.nA) total += static_cast<long long>(count - fs.nA) * fs.forfeitCost;
     }
 
     return total;
@@ -24,7 +33,7 @@ int calcularPenalidade(const Instance& inst, const std::vector<bool>& selecionad
 
 double get_objective_value(const std::vector<bool>& sol, const Instance& inst) {
     long long total_weight = 0;
-    int total_profit = 0;
+    long long total_profit = 0;
 
     for (int j = 0; j < inst.numItems; ++j) {
         if (sol[j]) {
@@ -38,31 +47,34 @@ double get_objective_value(const std::vector<bool>& sol, const Instance& inst) {
         return -DBL_MAX;
     }
 
-    int total_penalty = 0;
-    for (const auto& fs : inst.forfeitSets) {
-        int count_in_set = 0;
-        for (int item_id : fs.items) {
-            if (sol[item_id]) {
-                count_in_set++;
-            }
-        }
-        int violations = std::max(0, count_in_set - fs.nA);
-        total_penalty += violations * fs.forfeitCost;
-    }
-
+    long long total_penalty = calcularPenalidade(inst, sol);
     return static_cast<double>(total_profit - total_penalty);
 }
 
 // Função auxiliar para cálculo do peso.
-int calcularPeso(const Instance &inst, const std::vector<bool> &best_sol) {
-    int final_weight = 0;
-    int items_count = 0;
+long long calcularPeso(const Instance &inst, const std::vector<bool> &best_sol) {
+    long long final_weight = 0;
 
     for (size_t i = 0; i < best_sol.size(); ++i) {
         if (best_sol[i]) {
             final_weight += inst.weights[i];
-            items_count++;
         }
     }
     return final_weight;
 }
+
+// Preenche todas as métricas de um Resultado a partir da solução, com a mesma
+// regra de penalidade do objetivo.
+Resultado avaliarResultado(const Instance& inst, const std::vector<bool>& sol) {
+    Resultado res;
+    res.itensSelecionados = sol;
+    res.lucroTotal = 0;
+    for (int j = 0; j < inst.numItems; ++j) {
+        if (sol[j]) res.lucroTotal += inst.profits[j];
+    }
+    res.pesoTotal = calcularPeso(inst, sol);
+    res.penalidadeTotal = calcularPenalidade(inst, sol);
+    res.valorObjetivo = res.lucroTotal - res.penalidadeTotal;
+    res.tempoMs = 0.0;
+    return res;
+}
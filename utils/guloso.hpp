@@ -0,0 +1,86 @@
+#pragma once
+#include <vector>
+#include <random>
+#include <algorithm>
+#include "structs.hpp"
+#include "estado.hpp"
+#include "heap.hpp"
+
+// Tamanho máximo da lista restrita de candidatos (RCL) extraída do heap a cada passo.
+const int LIMITE_RCL = 64;
+
+// Valor marginal de adicionar o item j: lucro menos o custo dos conjuntos que já atingiram nA.
+long long valorMarginal(const EstadoSolucao& e, const Instance& inst, int j) {
+    return inst.profits[j] - deltaPenalidadeFlip(e, inst, j);
+}
+
+// Chave do heap: valor marginal por unidade de peso.
+double chaveGulosa(long long marginal, int peso) {
+    return static_cast<double>(marginal) / std::max(peso, 1);
+}
+
+/**
+ * @brief Construção gulosa ciente das penalidades sobre um heap indexado.
+ *
+ * Cada item não selecionado tem no heap seu valor marginal por unidade de peso. Ao adicionar
+ * um item, só mudam as chaves dos itens que compartilham com ele um conjunto que acabou de
+ * atingir nA. Como as chaves nunca aumentam, itens com valor marginal <= 0 ou que não cabem
+ * mais são descartados de vez. Custo O((n + Σ|conjunto|) log n).
+ *
+ * @param e Estado de partida (normalmente vazio); recebe a solução construída.
+ * @param alpha 0 = guloso puro; > 0 = escolha aleatória entre os max(1, alpha * |heap|)
+ *              melhores candidatos (limitado a LIMITE_RCL), como RCL do GRASP.
+ * @param rng Gerador usado quando alpha > 0.
+ */
+void construirGuloso(const Instance& inst, EstadoSolucao& e, double alpha, std::mt19937& rng) {
+    HeapIndexado heap(inst.numItems);
+    std::vector<int> ids;
+    std::vector<double> chaves(inst.numItems, 0.0);
+    for (int j = 0; j < inst.numItems; ++j) {
+        if (e.x[j] || !viavelAposFlip(e, inst, j)) continue;
+        long long marginal = valorMarginal(e, inst, j);
+        if (marginal <= 0) continue;
+        ids.push_back(j);
+        chaves[j] = chaveGulosa(marginal, inst.weights[j]);
+    }
+    heap.construir(ids, chaves);
+
+    std::vector<int> rcl, fronteira;
+    while (!heap.vazio()) {
+        int item;
+        if (alpha <= 0.0) {
+            item = heap.topo();
+            if (!viavelAposFlip(e, inst, item)) {
+                heap.remover(item);
+                continue;
+            }
+        } else {
+            int L = std::min(LIMITE_RCL, std::max(1, (int)(alpha * heap.tamanho())));
+            heap.melhores(L, rcl, fronteira);
+            // Descarta da RCL (e do heap) quem não cabe mais na capacidade residual
+            size_t validos = 0;
+            for (int c : rcl) {
+                if (viavelAposFlip(e, inst, c)) rcl[validos++] = c;
+                else heap.remover(c);
+            }
+            if (validos == 0) continue;
+            item = rcl[std::uniform_int_distribution<int>(0, validos - 1)(rng)];
+        }
+
+        heap.remover(item);
+        aplicarFlip(e, inst, item);
+
+        // Conjuntos que acabaram de atingir nA passam a penalizar seus demais itens
+        for (int p = inst.inicioConjuntosItem[item]; p < inst.inicioConjuntosItem[item + 1]; ++p) {
+            int s = inst.conjuntosDoItem[p];
+            const auto& fs = inst.forfeitSets[s];
+            if (e.contagem[s] != fs.nA) continue;
+            for (int outro : fs.items) {
+                if (!heap.contem(outro)) continue;
+                long long marginal = valorMarginal(e, inst, outro);
+                if (marginal <= 0) heap.remover(outro);
+                else heap.atualizar(outro, chaveGulosa(marginal, inst.weights[outro]));
+            }
+        }
+    }
+}
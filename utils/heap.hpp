@@ -0,0 +1,95 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+
+// Heap de máximo indexado por id (0..n-1): permite alterar ou remover a chave de um id
+// específico em O(log n), além de consultar o topo e os L melhores.
+struct HeapIndexado {
+    std::vector<int> heap;       // Ids na ordem do heap
+    std::vector<int> posicao;    // Posição de cada id em 'heap' (-1 = fora do heap)
+    std::vector<double> chave;
+
+    explicit HeapIndexado(int n) : posicao(n, -1), chave(n, 0.0) {}
+
+    bool vazio() const { return heap.empty(); }
+    int tamanho() const { return heap.size(); }
+    bool contem(int id) const { return posicao[id] != -1; }
+    int topo() const { return heap[0]; }
+
+    // Monta o heap com os ids dados em O(n).
+    void construir(const std::vector<int>& ids, const std::vector<double>& chaves) {
+        heap = ids;
+        for (size_t p = 0; p < heap.size(); ++p) {
+            posicao[heap[p]] = p;
+            chave[heap[p]] = chaves[heap[p]];
+        }
+        for (int p = (int)heap.size() / 2 - 1; p >= 0; --p) descer(p);
+    }
+
+    void atualizar(int id, double k) {
+        double antiga = chave[id];
+        chave[id] = k;
+        if (k > antiga) subir(posicao[id]);
+        else descer(posicao[id]);
+    }
+
+    void remover(int id) {
+        int p = posicao[id];
+        trocar(p, heap.size() - 1);
+        heap.pop_back();
+        posicao[id] = -1;
+        if (p < (int)heap.size()) {
+            subir(p);
+            descer(p);
+        }
+    }
+
+    // Coleta em 'saida' os (até) L ids de maior chave, sem alterar o heap, em O(L log L).
+    // 'fronteira' é um buffer auxiliar reaproveitado entre chamadas.
+    void melhores(int L, std::vector<int>& saida, std::vector<int>& fronteira) const {
+        saida.clear();
+        fronteira.clear();
+        if (heap.empty()) return;
+        auto menor = [&](int a, int b) { return chave[heap[a]] < chave[heap[b]]; };
+        fronteira.push_back(0);
+        while (!fronteira.empty() && (int)saida.size() < L) {
+            std::pop_heap(fronteira.begin(), fronteira.end(), menor);
+            int p = fronteira.back();
+            fronteira.pop_back();
+            saida.push_back(heap[p]);
+            for (int f = 2 * p + 1; f <= 2 * p + 2 && f < (int)heap.size(); ++f) {
+                fronteira.push_back(f);
+                std::push_heap(fronteira.begin(), fronteira.end(), menor);
+            }
+        }
+    }
+
+private:
+    void trocar(int a, int b) {
+        std::swap(heap[a], heap[b]);
+        posicao[heap[a]] = a;
+        posicao[heap[b]] = b;
+    }
+
+    void subir(int p) {
+        while (p > 0) {
+            int pai = (p - 1) / 2;
+            if (chave[heap[pai]] >= chave[heap[p]]) break;
+            trocar(p, pai);
+            p = pai;
+        }
+    }
+
+    void descer(int p) {
+        int n = heap.size();
+        while (true) {
+            int maior = p;
+            int esq = 2 * p + 1, dir = 2 * p + 2;
+            if (esq < n && chave[heap[esq]] > chave[heap[maior]]) maior = esq;
+            if (dir < n && chave[heap[dir]] > chave[heap[maior]]) maior = dir;
+            if (maior == p) break;
+            trocar(p, maior);
+            p = maior;
+        }
+    }
+};
@@ -6,6 +6,23 @@
 #include <iostream>
 #include "../utils/structs.hpp"
 
+// Constrói o índice item -> conjuntos (CSR) a partir das listas de itens de cada conjunto.
+// Memória O(n + Σ|conjunto|).
+void indexarConjuntos(Instance& inst) {
+    inst.inicioConjuntosItem.assign(inst.numItems + 1, 0);
+    for (const auto& fs : inst.forfeitSets) {
+        for (int item : fs.items) inst.inicioConjuntosItem[item + 1]++;
+    }
+    for (int j = 0; j < inst.numItems; ++j) {
+        inst.inicioConjuntosItem[j + 1] += inst.inicioConjuntosItem[j];
+    }
+    inst.conjuntosDoItem.resize(inst.inicioConjuntosItem[inst.numItems]);
+    std::vector<int> pos(inst.inicioConjuntosItem.begin(), inst.inicioConjuntosItem.end() - 1);
+    for (int s = 0; s < inst.numSets; ++s) {
+        for (int item : inst.forfeitSets[s].items) inst.conjuntosDoItem[pos[item]++] = s;
+    }
+}
+
 Instance lerInstancia(const std::string& caminho) {
     std::ifstream arq(caminho);
     if (!arq.is_open()) {
@@ -35,9 +52,13 @@ Instance lerInstancia(const std::string& caminho) {
         inst.forfeitSets[s].items.resize(nI);
         for (int j = 0; j < nI; ++j) {
             arq >> inst.forfeitSets[s].items[j];
+            if (inst.forfeitSets[s].items[j] < 0 || inst.forfeitSets[s].items[j] >= inst.numItems) {
+                throw std::runtime_error("Item fora do intervalo no conjunto " + std::to_string(s) + ": " + caminho);
+            }
         }
     }
 
+    indexarConjuntos(inst);
     return inst;
 }
 
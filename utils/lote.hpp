@@ -0,0 +1,183 @@
+#pragma once
+#include <algorithm>
+#include <cfloat>
+#include <cstdint>
+#include <vector>
+#include <omp.h>
+#include "structs.hpp"
+#include "parallel.hpp"
+#include "rastreio.hpp"
+
+// Avaliação em lote "bit-fatiada" (bit-sliced) de uma população inteira. A população é transposta
+// em faixas: para cada item, uma palavra de 64, 256 ou 512 bits cujo bit l diz se o indivíduo l
+// do bloco contém o item. Peso, lucro, contagem de cada conjunto e penalidade são acumulados
+// verticalmente (plano k = bit k do valor de todos os indivíduos), com somadores de vai-um
+// aplicados a palavras inteiras. Assim, uma única passada pelos itens e pelos conjuntos avalia
+// 64*W indivíduos, e o custo deixa de crescer com (indivíduos x tamanho da instância): o que resta
+// proporcional a isso é a leitura dos bits na transposição.
+
+// Faixa de 64*W indivíduos: o indivíduo l do bloco é o bit (l % 64) da palavra l / 64.
+template <int W>
+struct Faixa {
+    uint64_t p[W];
+};
+
+template <int W>
+bool faixaVazia(const Faixa<W>& a) {
+    uint64_t ou = 0;
+    #pragma omp simd reduction(|:ou)
+    for (int w = 0; w < W; ++w) ou |= a.p[w];
+    return ou == 0;
+}
+
+// Acumulador vertical de valores de 64 bits (aritmética módulo 2^64, como long long).
+template <int W>
+struct AcumuladorFatiado {
+    Faixa<W> plano[64] = {};
+    int planos = 0;   // Planos acima deste são nulos
+
+    // Soma a constante c aos indivíduos marcados em m (vai-um propagado palavra a palavra).
+    void somar(uint64_t c, const Faixa<W>& m) {
+        Faixa<W> vai = {};
+        int k = 0;
+        for (; k < 64 && (c != 0 || !faixaVazia(vai)); ++k, c >>= 1) {
+            Faixa<W>& s = plano[k];
+            if (c & 1) {
+                #pragma omp simd
+                for (int w = 0; w < W; ++w) {
+                    uint64_t soma = s.p[w] ^ m.p[w];
+                    uint64_t v = (s.p[w] & m.p[w]) | (vai.p[w] & soma);
+                    s.p[w] = soma ^ vai.p[w];
+                    vai.p[w] = v;
+                }
+            } else {
+                #pragma omp simd
+                for (int w = 0; w < W; ++w) {
+                    uint64_t v = s.p[w] & vai.p[w];
+                    s.p[w] ^= vai.p[w];
+                    vai.p[w] = v;
+                }
+            }
+        }
+        planos = std::max(planos, k);
+    }
+
+    long long valor(int l) const {
+        uint64_t v = 0;
+        for (int k = 0; k < planos; ++k) v |= ((plano[k].p[l >> 6] >> (l & 63)) & 1ULL) << k;
+        return static_cast<long long>(v);
+    }
+};
+
+/**
+ * @brief Avalia um bloco de até 64*W indivíduos com a mesma regra de calculate_objective_dbl_min:
+ *        lucro - penalidade, ou DBL_MIN se o peso exceder a capacidade.
+ * @param colunas Buffer de n faixas (reutilizado entre blocos da mesma thread).
+ */
+template <int W>
+void avaliarBlocoFatiado(const std::vector<std::vector<bool>>& populacao, int inicio, int fim, const Instance& inst,
+                         std::vector<double>& fitness, std::vector<Faixa<W>>& colunas) {
+    const int n = inst.numItems;
+
+    // 1. Transposição: colunas[j] = indivíduos do bloco que contêm o item j
+    colunas.assign(n, Faixa<W>{});
+    for (int i = inicio; i < fim; ++i) {
+        const int l = i - inicio;
+        const int palavra = l >> 6, deslocamento = l & 63;
+        const std::vector<bool>& x = populacao[i];
+        for (int j = 0; j < n; ++j) {
+            colunas[j].p[palavra] |= static_cast<uint64_t>(x[j]) << deslocamento;   // Sem desvio: bits aleatórios
+        }
+    }
+
+    // 2. Peso e lucro: uma passada pelos itens
+    AcumuladorFatiado<W> peso, lucro, penalidade;
+    for (int j = 0; j < n; ++j) {
+        if (faixaVazia(colunas[j])) continue;
+        peso.somar(static_cast<uint64_t>(static_cast<long long>(inst.weights[j])), colunas[j]);
+        lucro.somar(static_cast<uint64_t>(static_cast<long long>(inst.profits[j])), colunas[j]);
+    }
+
+    // 3. Conjuntos: contador vertical por conjunto, excesso sobre nA e custo por item excedente
+    Faixa<W> contagem[32];
+    for (const auto& fs : inst.forfeitSets) {
+        const int tamanho = static_cast<int>(fs.items.size());
+        if (tamanho <= fs.nA || fs.forfeitCost == 0) continue;   // Nunca penaliza
+        int planos = 0;
+        while ((1LL << planos) <= tamanho) ++planos;
+        std::fill(contagem, contagem + planos, Faixa<W>{});
+
+        for (int item : fs.items) {
+            Faixa<W> vai = colunas[item];
+            for (int k = 0; k < planos && !faixaVazia(vai); ++k) {
+                #pragma omp simd
+                for (int w = 0; w < W; ++w) {
+                    uint64_t v = contagem[k].p[w] & vai.p[w];
+                    contagem[k].p[w] ^= vai.p[w];
+                    vai.p[w] = v;
+                }
+            }
+        }
+
+        // excesso = contagem - nA (subtrator completo); o empréstimo final marca contagem < nA
+        Faixa<W> emprestimo = {};
+        for (int k = 0; k < planos; ++k) {
+            const uint64_t a = ((fs.nA >> k) & 1) ? ~0ULL : 0ULL;
+            #pragma omp simd
+            for (int w = 0; w < W; ++w) {
+                uint64_t c = contagem[k].p[w], b = emprestimo.p[w];
+                contagem[k].p[w] = c ^ a ^ b;
+                emprestimo.p[w] = (~c & (a | b)) | (a & b & c);
+            }
+        }
+        const uint64_t custo = static_cast<uint64_t>(static_cast<long long>(fs.forfeitCost));
+        for (int k = 0; k < planos; ++k) {
+            Faixa<W> m;
+            #pragma omp simd
+            for (int w = 0; w < W; ++w) m.p[w] = contagem[k].p[w] & ~emprestimo.p[w];
+            if (!faixaVazia(m)) penalidade.somar(custo << k, m);
+        }
+    }
+
+    // 4. Volta para um valor por indivíduo
+    for (int i = inicio; i < fim; ++i) {
+        const int l = i - inicio;
+        if (peso.valor(l) > inst.capacity) {
+            fitness[i] = DBL_MIN;   // Solução inviável
+        } else {
+            fitness[i] = static_cast<double>(lucro.valor(l) - penalidade.valor(l));
+        }
+    }
+}
+
+/**
+ * @brief Avalia toda a população em blocos bit-fatiados, em paralelo entre blocos. A largura da
+ *        faixa é a maior (512, 256 ou 64 indivíduos) que ainda deixa um bloco por thread; as
+ *        operações sobre as W palavras de uma faixa são vetorizadas (SSE2 com -O2, AVX2/AVX-512
+ *        conforme o -march).
+ * @param fitness Saída, um valor por indivíduo (mesmo tamanho da população).
+ */
+void avaliarPopulacaoFatiada(const std::vector<std::vector<bool>>& populacao, const Instance& inst,
+                             std::vector<double>& fitness) {
+    const int tamanho = static_cast<int>(populacao.size());
+    const int threads = threadsDisponiveis();
+    int largura = 64;
+    if ((tamanho + 511) / 512 >= threads) largura = 512;
+    else if ((tamanho + 255) / 256 >= threads) largura = 256;
+    const int blocos = (tamanho + largura - 1) / largura;
+
+    #pragma omp parallel num_threads(std::max(1, std::min(threads, blocos)))
+    {
+        std::vector<Faixa<8>> colunas8;
+        std::vector<Faixa<4>> colunas4;
+        std::vector<Faixa<1>> colunas1;
+        #pragma omp for schedule(dynamic)
+        for (int b = 0; b < blocos; ++b) {
+            EscopoRastreio lote("lote bit-fatiado", "avaliacao");
+            const int inicio = b * largura, fim = std::min(tamanho, inicio + largura);
+            if (largura == 512) avaliarBlocoFatiado<8>(populacao, inicio, fim, inst, fitness, colunas8);
+            else if (largura == 256) avaliarBlocoFatiado<4>(populacao, inicio, fim, inst, fitness, colunas4);
+            else avaliarBlocoFatiado<1>(populacao, inicio, fim, inst, fitness, colunas1);
+        }
+    }
+}
@@ -0,0 +1,243 @@
+#pragma once
+#include <vector>
+#include <climits>
+#include <random>
+#include <algorithm>
+#include "structs.hpp"
+#include "estado.hpp"
+
+// Movimentos compostos guiados pelos conjuntos de penalidade. Candidatos:
+//  - conjuntos violados (contagem > nA): lista mantida pelo próprio estado a cada flip;
+//  - itens de entrada e de ejeção: os melhores por valor marginal (CandidatosMovimento).
+// Todo delta é exato: o movimento é aplicado sobre o estado e desfeito, sem alocar memória.
+
+enum TipoMovimento {
+    TROCA_CONJUNTO = 0,   // Tira um item de um conjunto violado e põe um item de fora dele
+    CADEIA_EJECAO  = 1,   // Insere um item, ejeta itens até caber e completa a capacidade
+    REMOCAO_PIOR   = 2,   // Tira o pior contribuinte de um conjunto violado
+    NUM_TIPOS_MOVIMENTO
+};
+
+const int MAX_ITENS_MOVIMENTO = 8;
+const int LIMITE_ENTRADA = 16;      // Itens de entrada considerados por movimento
+const int LIMITE_VIOLADOS = 32;     // Conjuntos violados examinados por varredura
+const int PROFUNDIDADE_CADEIA = 3;  // Ejeções por cadeia
+
+// Itens a inverter, na ordem, e a variação exata do objetivo.
+struct MovimentoComposto {
+    int tipo = -1;
+    int numItens = 0;
+    int itens[MAX_ITENS_MOVIMENTO];
+    long long delta = LLONG_MIN;
+
+    bool valido() const { return tipo != -1; }
+};
+
+void aplicarMovimento(EstadoSolucao& e, const Instance& inst, const MovimentoComposto& mov) {
+    for (int t = 0; t < mov.numItens; ++t) aplicarFlip(e, inst, mov.itens[t]);
+}
+
+void desfazerMovimento(EstadoSolucao& e, const Instance& inst, const MovimentoComposto& mov) {
+    for (int t = mov.numItens - 1; t >= 0; --t) aplicarFlip(e, inst, mov.itens[t]);
+}
+
+bool pertenceAoConjunto(const Instance& inst, int item, int conjunto) {
+    for (int p = inst.inicioConjuntosItem[item]; p < inst.inicioConjuntosItem[item + 1]; ++p) {
+        if (inst.conjuntosDoItem[p] == conjunto) return true;
+    }
+    return false;
+}
+
+// Listas de candidatos de um estado.
+struct CandidatosMovimento {
+    std::vector<std::pair<long long, int>> entrada;   // (valor marginal, item) não selecionados, decrescente
+    std::vector<std::pair<double, int>> ejecao;       // (variação por peso ao remover, item) selecionados, decrescente
+};
+
+// Mantém os LIMITE_ENTRADA maiores pares de 'lista', em ordem decrescente (pares distintos:
+// o resultado não depende da ordem de chegada).
+template <typename Par>
+void manterMelhores(std::vector<Par>& lista) {
+    if ((int)lista.size() > LIMITE_ENTRADA) {
+        std::nth_element(lista.begin(), lista.begin() + LIMITE_ENTRADA, lista.end(), std::greater<>());
+        lista.resize(LIMITE_ENTRADA);
+    }
+    std::sort(lista.begin(), lista.end(), std::greater<>());
+}
+
+/**
+ * @brief Acrescenta a 'c' os candidatos dos itens em [inicio, fim): até LIMITE_ENTRADA itens não
+ *        selecionados de maior valor marginal positivo e até LIMITE_ENTRADA selecionados de menor
+ *        perda por unidade de peso. Faixas disjuntas podem ser coletadas por threads distintas e
+ *        juntadas com combinarCandidatos.
+ * @param penalidade penalidade(j) = penalidade do flip de j (ex.: já calculada pelo kernel de vizinhança).
+ */
+template <typename Penalidade>
+void coletarCandidatos(const Instance& inst, const EstadoSolucao& e, int inicio, int fim, Penalidade penalidade,
+                       CandidatosMovimento& c) {
+    for (int j = inicio; j < fim; ++j) {
+        long long pen = penalidade(j);
+        if (e.x[j]) {
+            c.ejecao.push_back({(double)(-inst.profits[j] - pen) / std::max(inst.weights[j], 1), j});
+        } else if (inst.profits[j] - pen > 0) {
+            c.entrada.push_back({inst.profits[j] - pen, j});
+        }
+    }
+    manterMelhores(c.entrada);
+    manterMelhores(c.ejecao);
+}
+
+// Junta em 'a' os candidatos de 'b' (de outra faixa), mantendo os melhores de cada lista.
+void combinarCandidatos(CandidatosMovimento& a, const CandidatosMovimento& b) {
+    a.entrada.insert(a.entrada.end(), b.entrada.begin(), b.entrada.end());
+    a.ejecao.insert(a.ejecao.end(), b.ejecao.begin(), b.ejecao.end());
+    manterMelhores(a.entrada);
+    manterMelhores(a.ejecao);
+}
+
+// Candidatos de todo o estado, numa passada O(n + Σ|conjunto|).
+void prepararCandidatos(const Instance& inst, const EstadoSolucao& e, CandidatosMovimento& c) {
+    c.entrada.clear();
+    c.ejecao.clear();
+    coletarCandidatos(inst, e, 0, inst.numItems, [&](int j) { return deltaPenalidadeFlip(e, inst, j); }, c);
+}
+
+// Troca no conjunto 's' violado: sai 'sai', entra o primeiro candidato de fora de 's' que caiba.
+MovimentoComposto trocaNoConjunto(const Instance& inst, EstadoSolucao& e, int s, int sai,
+                                  const CandidatosMovimento& c) {
+    MovimentoComposto mov;
+    long long residual = inst.capacity - e.peso + inst.weights[sai];
+    for (const auto& [marginal, entra] : c.entrada) {
+        if (inst.weights[entra] > residual || pertenceAoConjunto(inst, entra, s)) continue;
+        mov.tipo = TROCA_CONJUNTO;
+        mov.numItens = 2;
+        mov.itens[0] = sai;
+        mov.itens[1] = entra;
+        mov.delta = deltaObjetivoTroca(e, inst, entra, sai);
+        break;
+    }
+    return mov;
+}
+
+// Melhor troca entre os primeiros LIMITE_VIOLADOS conjuntos violados.
+MovimentoComposto melhorTrocaConjunto(const Instance& inst, EstadoSolucao& e,
+                                      const CandidatosMovimento& c) {
+    MovimentoComposto melhor;
+    int limite = std::min<int>(e.violados.size(), LIMITE_VIOLADOS);
+    for (int v = 0; v < limite; ++v) {
+        int s = e.violados[v];
+        for (int sai : inst.forfeitSets[s].items) {
+            if (!e.x[sai]) continue;
+            MovimentoComposto mov = trocaNoConjunto(inst, e, s, sai, c);
+            if (mov.valido() && mov.delta > melhor.delta) melhor = mov;
+        }
+    }
+    return melhor;
+}
+
+// Pior contribuinte do conjunto 's': o item selecionado cuja remoção mais melhora o objetivo.
+MovimentoComposto remocaoNoConjunto(const Instance& inst, const EstadoSolucao& e, int s) {
+    MovimentoComposto mov;
+    for (int j : inst.forfeitSets[s].items) {
+        if (!e.x[j]) continue;
+        long long delta = deltaObjetivoFlip(e, inst, j);
+        if (delta > mov.delta) {
+            mov.tipo = REMOCAO_PIOR;
+            mov.numItens = 1;
+            mov.itens[0] = j;
+            mov.delta = delta;
+        }
+    }
+    return mov;
+}
+
+MovimentoComposto melhorRemocaoViolado(const Instance& inst, const EstadoSolucao& e) {
+    MovimentoComposto melhor;
+    int limite = std::min<int>(e.violados.size(), LIMITE_VIOLADOS);
+    for (int v = 0; v < limite; ++v) {
+        MovimentoComposto mov = remocaoNoConjunto(inst, e, e.violados[v]);
+        if (mov.valido() && mov.delta > melhor.delta) melhor = mov;
+    }
+    return melhor;
+}
+
+/**
+ * @brief Cadeia de ejeção iniciada pela inserção de 'entra': enquanto a capacidade estoura,
+ *        ejeta o próximo item da lista de ejeção (menor perda por peso, até PROFUNDIDADE_CADEIA)
+ *        e depois completa a capacidade residual com os candidatos de entrada que couberem.
+ *        O estado volta ao original; a cadeia é válida se terminar viável.
+ */
+MovimentoComposto cadeiaEjecao(const Instance& inst, EstadoSolucao& e, int entra, const CandidatosMovimento& c) {
+    MovimentoComposto mov;
+    long long antes = e.objetivo();
+    mov.itens[mov.numItens++] = entra;
+    aplicarFlip(e, inst, entra);
+
+    for (size_t t = 0; t < c.ejecao.size() && e.peso > inst.capacity && mov.numItens <= PROFUNDIDADE_CADEIA; ++t) {
+        mov.itens[mov.numItens++] = c.ejecao[t].second;
+        aplicarFlip(e, inst, c.ejecao[t].second);
+    }
+
+    if (e.peso <= inst.capacity) {
+        // Completa a capacidade residual
+        for (const auto& [marginal, j] : c.entrada) {
+            if (mov.numItens == MAX_ITENS_MOVIMENTO) break;
+            if (e.x[j] || !viavelAposFlip(e, inst, j) || deltaObjetivoFlip(e, inst, j) <= 0) continue;
+            mov.itens[mov.numItens++] = j;
+            aplicarFlip(e, inst, j);
+        }
+        mov.tipo = CADEIA_EJECAO;
+        mov.delta = e.objetivo() - antes;
+    }
+    desfazerMovimento(e, inst, mov);
+    if (!mov.valido()) mov.numItens = 0;
+    return mov;
+}
+
+// Melhor cadeia entre os candidatos de entrada que não cabem diretamente na mochila.
+MovimentoComposto melhorCadeiaEjecao(const Instance& inst, EstadoSolucao& e,
+                                     const CandidatosMovimento& c) {
+    MovimentoComposto melhor;
+    for (const auto& [marginal, entra] : c.entrada) {
+        if (viavelAposFlip(e, inst, entra)) continue;   // Caberia sozinho: já é um flip simples
+        MovimentoComposto mov = cadeiaEjecao(inst, e, entra, c);
+        if (mov.valido() && mov.delta > melhor.delta) melhor = mov;
+    }
+    return melhor;
+}
+
+// Melhor movimento composto dos três tipos.
+MovimentoComposto melhorMovimentoComposto(const Instance& inst, EstadoSolucao& e,
+                                          const CandidatosMovimento& c) {
+    MovimentoComposto melhor = melhorTrocaConjunto(inst, e, c);
+    MovimentoComposto mov = melhorCadeiaEjecao(inst, e, c);
+    if (mov.valido() && mov.delta > melhor.delta) melhor = mov;
+    mov = melhorRemocaoViolado(inst, e);
+    if (mov.valido() && mov.delta > melhor.delta) melhor = mov;
+    return melhor;
+}
+
+/**
+ * @brief Movimento aleatório do tipo pedido (perturbação do VNS): conjunto violado, item que
+ *        sai e item que entra sorteados entre os candidatos. Inválido se não houver candidatos.
+ */
+MovimentoComposto movimentoAleatorio(int tipo, const Instance& inst, EstadoSolucao& e,
+                                     const CandidatosMovimento& c, std::mt19937_64& rng) {
+    if (tipo == CADEIA_EJECAO) {
+        if (c.entrada.empty()) return MovimentoComposto();
+        int entra = c.entrada[std::uniform_int_distribution<int>(0, c.entrada.size() - 1)(rng)].second;
+        return cadeiaEjecao(inst, e, entra, c);
+    }
+    if (e.violados.empty()) return MovimentoComposto();
+    int s = e.violados[std::uniform_int_distribution<int>(0, e.violados.size() - 1)(rng)];
+    if (tipo == REMOCAO_PIOR) return remocaoNoConjunto(inst, e, s);
+
+    // TROCA_CONJUNTO: item de saída sorteado entre os selecionados do conjunto
+    const auto& itens = inst.forfeitSets[s].items;
+    int selecionados = 0, sai = -1;
+    for (int j : itens) {
+        if (e.x[j] && std::uniform_int_distribution<int>(0, selecionados++)(rng) == 0) sai = j;   // Amostragem por reservatório
+    }
+    if (sai == -1) return MovimentoComposto();
+    return trocaNoConjunto(inst, e, s, sai, c);
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <omp.h>
+
+// Orçamento de threads definido pelo chamador (0 = usa omp_get_max_threads()).
+// É thread_local para que solvers executados lado a lado possam ter orçamentos distintos.
+thread_local int orcamentoThreads = 0;
+
+void definirOrcamentoThreads(int n) {
+    orcamentoThreads = std::max(0, n);
+}
+
+int threadsDisponiveis() {
+    return orcamentoThreads > 0 ? orcamentoThreads : omp_get_max_threads();
+}
+
+// Plano de execução de um laço paralelo: tamanho da equipe e do bloco de iterações.
+struct PlanoParalelo {
+    int threads = 1;   // 1 = execução serial (a região é aberta com if(false))
+    int chunk = 1;     // Iterações por bloco no escalonamento do laço
+};
+
+// Mede o custo médio (ns) de uma chamada de 'f', repetindo até acumular ~50us.
+template <typename F>
+double medirCustoNs(F&& f, int minRepeticoes = 3) {
+    using relogio = std::chrono::steady_clock;
+    int repeticoes = 0;
+    auto inicio = relogio::now();
+    double decorrido = 0.0;
+    do {
+        f();
+        ++repeticoes;
+        decorrido = std::chrono::duration<double, std::nano>(relogio::now() - inicio).count();
+    } while (repeticoes < minRepeticoes || (decorrido < 50000.0 && repeticoes < 1000));
+    return decorrido / repeticoes;
+}
+
+// Custo (ns) de um ponto de sincronização (barreira) numa equipe de 'threads' threads.
+// Medido uma vez por tamanho de equipe e guardado em cache.
+double custoSincronizacaoNs(int threads) {
+    static std::mutex mtx;
+    static std::map<int, double> cache;
+    if (threads <= 1) return 0.0;
+
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = cache.find(threads);
+    if (it != cache.end()) return it->second;
+
+    const int barreiras = 50;
+    auto inicio = std::chrono::steady_clock::now();
+    #pragma omp parallel num_threads(threads) proc_bind(close)
+    {
+        for (int b = 0; b < barreiras; ++b) {
+            #pragma omp barrier
+        }
+    }
+    double total = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - inicio).count();
+    double custo = total / barreiras;
+    cache[threads] = custo;
+    return custo;
+}
+
+/**
+ * @brief Modelo de custo para decidir entre execução serial e paralela de um laço.
+ * @param tarefas Número de iterações independentes do laço.
+ * @param custoTarefaNs Custo medido de uma iteração (ns).
+ * @param sincronizacoes Barreiras/críticas executadas a cada execução do laço.
+ * @return Plano com o número de threads que minimiza trabalho/p + sincronização(p),
+ *         respeitando o orçamento do chamador, e o chunk correspondente.
+ */
+PlanoParalelo planejarParalelismo(long long tarefas, double custoTarefaNs, int sincronizacoes = 1) {
+    PlanoParalelo plano;
+    int maxThreads = static_cast<int>(std::min<long long>(threadsDisponiveis(), std::max(1LL, tarefas)));
+    double trabalho = tarefas * custoTarefaNs;
+    double melhorTempo = trabalho;
+
+    for (int p = 2; p <= maxThreads; p *= 2) {
+        double tempo = trabalho / p + sincronizacoes * custoSincronizacaoNs(p);
+        if (tempo < melhorTempo) {
+            melhorTempo = tempo;
+            plano.threads = p;
+        }
+    }
+    if (maxThreads > 1 && (maxThreads & (maxThreads - 1)) != 0) {
+        double tempo = trabalho / maxThreads + sincronizacoes * custoSincronizacaoNs(maxThreads);
+        if (tempo < melhorTempo) plano.threads = maxThreads;
+    }
+
+    // Blocos de pelo menos ~2us para amortizar o despacho, sem deixar threads ociosas.
+    long long porThread = (tarefas + plano.threads - 1) / plano.threads;
+    long long minimo = static_cast<long long>(2000.0 / std::max(custoTarefaNs, 1.0)) + 1;
+    plano.chunk = static_cast<int>(std::max(1LL, std::min(porThread, minimo)));
+    return plano;
+}
@@ -0,0 +1,142 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+#include <filesystem>
+
+// Hiperparâmetros dos solvers, identificados por "<algoritmo>.<nome>" (ex.: "tabu.tabu_tenure").
+// Os valores padrão são os mesmos dos argumentos padrão de cada solver.
+using Parametros = std::map<std::string, double>;
+
+struct EspecParametro {
+    std::string nome;
+    double padrao;
+    double minimo;     // Intervalo usado pelo ajuste automático (main_tuning)
+    double maximo;
+    bool inteiro;
+};
+
+const std::vector<EspecParametro>& especParametros() {
+    static const std::vector<EspecParametro> especs = {
+        {"grasp.maxIter",                   1000,   100,    5000,    true},
+        {"grasp.alpha",                     0.2,    0.0,    0.6,     false},
+        {"tabu.max_iter",                   1000,   200,    5000,    true},
+        {"tabu.tabu_tenure",                7,      1,      50,      true},
+        {"tabu.movimentos_compostos",       1,      0,      1,       true},
+        {"vns.max_generations",             3000,   500,    10000,   true},
+        {"vns.maxGenEstagnated_ratio",      0.3,    0.05,   0.5,     false},
+        {"vns.threshold",                   0.01,   0.0001, 0.05,    false},
+        {"vns.k_max",                       10,     2,      40,      true},
+        {"vns.movimentos_compostos",        1,      0,      1,       true},
+        {"genetic.population_size",         500,    50,     1000,    true},
+        {"genetic.max_generations",         5000,   500,    10000,   true},
+        {"genetic.crossover_rate",          0.9,    0.5,    1.0,     false},
+        {"genetic.mutation_rate",           0.35,   0.01,   0.8,     false},
+        {"genetic.maxGenEstagnated",        0.2,    0.05,   0.5,     false},
+        {"genetic.threshold",               0.005,  0.0001, 0.05,    false},
+        {"genetic.avaliacao_lote",          1,      0,      1,       true},
+        {"lns.max_iter",                    5000,   500,    20000,   true},
+        {"lns.k_livres",                    16,     4,      24,      true},
+        {"lns.limite_nos",                  200000, 10000,  1000000, true},
+        {"lns.maxIterEstagnado",            0.3,    0.05,   0.5,     false},
+        {"tempera.max_varreduras",          2000,   200,    20000,   true},
+        {"tempera.temp_min",                0.02,   0.001,  0.2,     false},
+        {"tempera.temp_max",                1.0,    0.2,    5.0,     false},
+        {"tempera.intervalo_troca",         10,     1,      100,     true},
+        {"tempera.replicas",                0,      0,      32,      true},
+        {"tempera.maxEstagnado",            0.3,    0.05,   0.5,     false},
+        {"exato.limite_nos",                1e9,    1e5,    1e10,    true},
+        {"exato.tempo_limite_seg",          60,     1,      600,     false},
+        {"exato.incumbente_lns",            1,      0,      1,       true},
+        {"portfolio.tempo_seg",             60,     1,      600,     false},
+    };
+    return especs;
+}
+
+Parametros parametrosPadrao() {
+    Parametros p;
+    for (const auto& e : especParametros()) p[e.nome] = e.padrao;
+    return p;
+}
+
+// Especificações dos parâmetros de um algoritmo (prefixo "<algoritmo>.").
+std::vector<EspecParametro> especParametrosDe(const std::string& algoritmo) {
+    std::vector<EspecParametro> saida;
+    for (const auto& e : especParametros()) {
+        if (e.nome.compare(0, algoritmo.size() + 1, algoritmo + ".") == 0) saida.push_back(e);
+    }
+    return saida;
+}
+
+// Remove espaços em branco das pontas.
+std::string aparar(const std::string& texto) {
+    const char* brancos = " \t\r\n";
+    size_t inicio = texto.find_first_not_of(brancos);
+    if (inicio == std::string::npos) return "";
+    return texto.substr(inicio, texto.find_last_not_of(brancos) - inicio + 1);
+}
+
+/**
+ * @brief Lê linhas "chave=valor" (linhas iniciadas por '#' são comentários) e sobrescreve os
+ *        valores correspondentes em 'params'. Espaços em volta da chave e do valor são ignorados.
+ * @param estrito Se true, chave desconhecida ou valor inválido lançam exceção; senão, chaves
+ *        desconhecidas são ignoradas com aviso.
+ */
+void lerParametros(std::istream& entrada, Parametros& params, bool estrito = false) {
+    std::string linha;
+    while (std::getline(entrada, linha)) {
+        linha = aparar(linha);
+        if (linha.empty() || linha[0] == '#') continue;
+        size_t igual = linha.find('=');
+        if (igual == std::string::npos) continue;
+        std::string chave = aparar(linha.substr(0, igual));
+        std::string valor = aparar(linha.substr(igual + 1));
+        if (params.find(chave) == params.end()) {
+            if (estrito) throw std::runtime_error("Parametro desconhecido: " + chave);
+            std::cerr << "Aviso: parametro desconhecido ignorado: " << chave << "\n";
+            continue;
+        }
+        size_t lidos = 0;
+        double numero = 0.0;
+        try {
+            numero = std::stod(valor, &lidos);
+        } catch (const std::logic_error&) {
+            lidos = 0;
+        }
+        if (lidos == 0 || lidos != valor.size()) {
+            throw std::runtime_error("Valor invalido para o parametro " + chave + ": " + valor);
+        }
+        params[chave] = numero;
+    }
+}
+
+// Lê um arquivo no formato de lerParametros.
+void carregarParametros(const std::filesystem::path& caminho, Parametros& params) {
+    std::ifstream arq(caminho);
+    if (!arq.is_open()) {
+        throw std::runtime_error("Erro ao abrir o arquivo de parametros: " + caminho.string());
+    }
+    lerParametros(arq, params);
+}
+
+// Grava os parâmetros de 'algoritmo' no formato lido por carregarParametros.
+void salvarParametros(const std::filesystem::path& caminho, const Parametros& params,
+                      const std::string& algoritmo, const std::string& comentario = "") {
+    if (caminho.has_parent_path()) std::filesystem::create_directories(caminho.parent_path());
+    std::ofstream out(caminho);
+    out << std::setprecision(std::numeric_limits<double>::max_digits10);   // Valores voltam idênticos
+    if (!comentario.empty()) {
+        std::istringstream linhas(comentario);
+        std::string linha;
+        while (std::getline(linhas, linha)) out << "# " << linha << "\n";
+    }
+    for (const auto& e : especParametrosDe(algoritmo)) {
+        out << e.nome << "=" << params.at(e.nome) << "\n";
+    }
+}
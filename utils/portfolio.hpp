@@ -0,0 +1,136 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "structs.hpp"
+#include "estado.hpp"
+#include "registro.hpp"
+
+// Cooperação entre solvers executados em portfólio (algorithms/portfolio.cpp): incumbente
+// global compartilhado, prazo único de relógio e troca de soluções de elite.
+
+// Solução publicada no incumbente global. Imutável depois de publicada.
+struct SolucaoPublicada {
+    long long objetivo;
+    std::vector<bool> itens;
+    std::string origem;                 // Solver que a encontrou
+    double tempoMs;                     // Instante da publicação, desde o início do portfólio
+};
+
+// Registro de uma publicação vencedora, sem a solução (trajetória e log do portfólio).
+struct PublicacaoIncumbente {
+    double tempoMs;
+    std::string origem;
+    long long objetivo;
+};
+
+/**
+ * @brief Incumbente global: o objetivo é um atômico e a solução, um shared_ptr trocado por CAS
+ *        (std::atomic_compare_exchange).
+ *
+ * A rejeição de uma publicação, o caso comum, custa uma leitura atômica do objetivo, sem travas;
+ * só uma melhoria aloca e troca o ponteiro. Uma solução substituída é liberada quando o último
+ * leitor que a importou a solta, então a memória fica em O(n) por membro, e não por melhoria;
+ * do histórico só ficam tempo, origem e objetivo.
+ */
+struct IncumbenteGlobal {
+    std::shared_ptr<const SolucaoPublicada> melhor;   // Acesso só por std::atomic_load/atomic_compare_exchange
+    std::atomic<long long> objetivoAtual{LLONG_MIN};
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    std::mutex mtxHistorico;
+    std::vector<PublicacaoIncumbente> historico;
+
+    IncumbenteGlobal() = default;
+    IncumbenteGlobal(const IncumbenteGlobal&) = delete;
+    IncumbenteGlobal& operator=(const IncumbenteGlobal&) = delete;
+
+    long long objetivo() const { return objetivoAtual.load(std::memory_order_acquire); }
+
+    std::shared_ptr<const SolucaoPublicada> ler() const { return std::atomic_load(&melhor); }
+
+    // Publica 'itens' se superar o incumbente; devolve true se a publicação venceu.
+    bool publicar(long long objetivo, const std::vector<bool>& itens, const std::string& origem) {
+        if (objetivoAtual.load(std::memory_order_acquire) >= objetivo) return false;
+        double tempo = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count();
+        auto nova = std::make_shared<const SolucaoPublicada>(SolucaoPublicada{objetivo, itens, origem, tempo});
+        std::shared_ptr<const SolucaoPublicada> atual = std::atomic_load(&melhor);
+        do {
+            if (atual && atual->objetivo >= objetivo) return false;
+        } while (!std::atomic_compare_exchange_weak(&melhor, &atual, nova));
+
+        long long lido = objetivoAtual.load(std::memory_order_relaxed);
+        while (lido < objetivo && !objetivoAtual.compare_exchange_weak(lido, objetivo, std::memory_order_acq_rel)) {}
+        std::lock_guard<std::mutex> lock(mtxHistorico);
+        historico.push_back({tempo, origem, objetivo});
+        return true;
+    }
+
+    // Publicações vencedoras em ordem crescente de objetivo (= ordem de substituição).
+    std::vector<PublicacaoIncumbente> trajetoria() {
+        std::lock_guard<std::mutex> lock(mtxHistorico);
+        std::vector<PublicacaoIncumbente> saida = historico;
+        std::sort(saida.begin(), saida.end(),
+                  [](const PublicacaoIncumbente& a, const PublicacaoIncumbente& b) { return a.objetivo < b.objetivo; });
+        return saida;
+    }
+};
+
+struct ContextoPortfolio {
+    IncumbenteGlobal incumbente;
+    std::chrono::steady_clock::time_point prazo;
+};
+
+// Portfólio ao qual os solvers desta thread pertencem (nullptr = execução isolada).
+// Como a semente e o orçamento de threads, é lido uma vez por cada solver ao iniciar.
+thread_local ContextoPortfolio* portfolioAtual = nullptr;
+
+/**
+ * @brief Ponto de contato de um solver com o portfólio; sem portfólio, tudo vira no-op.
+ *
+ * prazoEsgotado() lê o relógio; publicar() e importar() custam uma leitura atômica quando
+ * não há novidade, então podem ser chamadas a cada iteração (em trecho serial).
+ *
+ * prazoEsgotado() também respeita o prazo e o cancelamento do acompanhamento do chamador
+ * (registro.hpp), com ou sem portfólio.
+ */
+struct Cooperacao {
+    ContextoPortfolio* ctx;
+    std::string origem;
+    long long objetivoImportado = LLONG_MIN;   // Objetivos publicados são crescentes: identificam a solução
+    const Acompanhamento* acompanhamento;
+
+    explicit Cooperacao(const std::string& origem)
+        : ctx(portfolioAtual), origem(origem), acompanhamento(acompanhamentoAtual) {}
+
+    bool ativa() const { return ctx != nullptr; }
+
+    bool prazoEsgotado() const {
+        return (ctx && std::chrono::steady_clock::now() >= ctx->prazo) || (acompanhamento && acompanhamento->esgotado());
+    }
+
+    void publicar(long long objetivo, const std::vector<bool>& itens) {
+        if (ctx && objetivo > ctx->incumbente.objetivo()) ctx->incumbente.publicar(objetivo, itens, origem);
+    }
+
+    void publicar(const EstadoSolucao& e) {
+        if (ctx && e.objetivo() > ctx->incumbente.objetivo()) {
+            ctx->incumbente.publicar(e.objetivo(), std::vector<bool>(e.x.begin(), e.x.end()), origem);
+        }
+    }
+
+    // Solução de elite ainda não importada e melhor que 'objetivo' (nullptr se não houver).
+    std::shared_ptr<const SolucaoPublicada> importar(long long objetivo) {
+        if (!ctx) return nullptr;
+        long long publicado = ctx->incumbente.objetivo();
+        if (publicado <= objetivo || publicado <= objetivoImportado) return nullptr;
+        std::shared_ptr<const SolucaoPublicada> s = ctx->incumbente.ler();
+        if (!s || s->objetivo <= objetivo || s->objetivo <= objetivoImportado) return nullptr;
+        objetivoImportado = s->objetivo;
+        return s;
+    }
+};
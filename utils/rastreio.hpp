@@ -0,0 +1,124 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+// Rastreio opcional da linha do tempo das threads (regiões paralelas, esperas em critical e
+// barreiras, lotes de avaliação, E/S), exportado no formato Chrome trace-event JSON
+// (chrome://tracing, Perfetto). Desligado, cada ponto de rastreio custa uma leitura atômica.
+//
+// Cada thread grava no próprio buffer, de capacidade fixa reservada no primeiro evento: o
+// caminho quente não trava nem aloca. Eventos além da capacidade são descartados e contados.
+// Nomes e categorias devem ser literais (só o ponteiro é guardado até a exportação).
+
+struct EventoRastreio {
+    const char* nome;
+    const char* categoria;
+    double inicioUs;
+    double duracaoUs;
+};
+
+struct BufferRastreio {
+    int tid;
+    std::vector<EventoRastreio> eventos;   // Reservado na criação; nunca realoca
+    long long descartados = 0;
+};
+
+struct Rastreador {
+    std::atomic<bool> ativo{false};
+    std::chrono::steady_clock::time_point inicio;
+    size_t capacidade = 1 << 17;                          // Eventos por thread (~4 MB)
+    std::mutex mtx;                                       // Só para registrar threads novas e exportar
+    std::vector<std::unique_ptr<BufferRastreio>> buffers; // Sobrevivem ao fim das threads
+};
+
+Rastreador rastreador;
+thread_local BufferRastreio* bufferRastreio = nullptr;
+
+// Liga o rastreio (uma vez por processo, antes dos solvers).
+void iniciarRastreio(size_t capacidadePorThread = 1 << 17) {
+    rastreador.capacidade = std::max<size_t>(capacidadePorThread, 1);
+    rastreador.inicio = std::chrono::steady_clock::now();
+    rastreador.ativo.store(true, std::memory_order_release);
+}
+
+bool rastreioAtivo() {
+    return rastreador.ativo.load(std::memory_order_relaxed);
+}
+
+// Instante atual em us desde iniciarRastreio(); -1 com o rastreio desligado.
+double instanteRastreioUs() {
+    if (!rastreioAtivo()) return -1.0;
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - rastreador.inicio).count();
+}
+
+BufferRastreio& bufferDaThread() {
+    if (!bufferRastreio) {
+        auto novo = std::make_unique<BufferRastreio>();
+        novo->eventos.reserve(rastreador.capacidade);
+        std::lock_guard<std::mutex> lock(rastreador.mtx);
+        novo->tid = rastreador.buffers.size();
+        bufferRastreio = novo.get();
+        rastreador.buffers.push_back(std::move(novo));
+    }
+    return *bufferRastreio;
+}
+
+// Registra o intervalo [inicioUs, agora) na thread atual (no-op se inicioUs < 0).
+void registrarIntervalo(const char* nome, const char* categoria, double inicioUs) {
+    if (inicioUs < 0.0) return;
+    double fim = instanteRastreioUs();
+    BufferRastreio& b = bufferDaThread();
+    if (b.eventos.size() < rastreador.capacidade) b.eventos.push_back({nome, categoria, inicioUs, fim - inicioUs});
+    else b.descartados++;
+}
+
+// Intervalo do escopo: do construtor ao destrutor.
+struct EscopoRastreio {
+    const char* nome;
+    const char* categoria;
+    double inicioUs;
+
+    EscopoRastreio(const char* nome, const char* categoria)
+        : nome(nome), categoria(categoria), inicioUs(instanteRastreioUs()) {}
+    ~EscopoRastreio() { registrarIntervalo(nome, categoria, inicioUs); }
+
+    EscopoRastreio(const EscopoRastreio&) = delete;
+    EscopoRastreio& operator=(const EscopoRastreio&) = delete;
+};
+
+/**
+ * @brief Grava os eventos de todas as threads em 'arquivo' (trace-event JSON, eventos "X").
+ *        Deve ser chamada fora de regiões paralelas, depois dos solvers.
+ * @return Número de eventos descartados por buffers cheios.
+ */
+long long exportarRastreio(const std::filesystem::path& arquivo) {
+    std::lock_guard<std::mutex> lock(rastreador.mtx);
+    if (arquivo.has_parent_path()) std::filesystem::create_directories(arquivo.parent_path());
+    std::ofstream out(arquivo);
+    if (!out.is_open()) throw std::runtime_error("Nao foi possivel gravar o rastreio: " + arquivo.string());
+
+    long long descartados = 0;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out.setf(std::ios::fixed);
+    out.precision(3);
+    bool primeiro = true;
+    for (const auto& b : rastreador.buffers) {
+        descartados += b->descartados;
+        out << (primeiro ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b->tid
+            << ",\"args\":{\"name\":\"thread " << b->tid << "\"}}";
+        primeiro = false;
+        for (const EventoRastreio& ev : b->eventos) {
+            out << ",\n{\"name\":\"" << ev.nome << "\",\"cat\":\"" << ev.categoria << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                << b->tid << ",\"ts\":" << ev.inicioUs << ",\"dur\":" << ev.duracaoUs << "}";
+        }
+    }
+    out << "\n],\"otherData\":{\"descartados\":" << descartados << "}}\n";
+    return descartados;
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <vector>
+#include "structs.hpp"
+
+// Semente da próxima execução de solver na thread chamadora (sem semente fixada = sorteada).
+// Cada solver lê a semente uma vez, antes de abrir sua região paralela, e deriva dela os
+// geradores internos; assim execuções repetidas com a mesma semente são reprodutíveis.
+thread_local bool temSementeFixada = false;
+thread_local unsigned sementeFixada = 0;
+
+void definirSemente(unsigned semente) {
+    temSementeFixada = true;
+    sementeFixada = semente;
+}
+
+unsigned sementeExecucao() {
+    return temSementeFixada ? sementeFixada : std::random_device{}();
+}
+
+/**
+ * @brief Acompanhamento de uma execução pelo chamador (ex.: a biblioteca, kpfs.h): prazo de
+ *        relógio, cancelamento e aviso a cada novo incumbente.
+ *
+ * notificar() pode ser chamada de qualquer thread: os avisos são serializados e só passam os
+ * objetivos que superam o último avisado, de modo que solvers aninhados (membros do portfólio,
+ * incumbente inicial do exato) produzem uma única sequência crescente.
+ */
+struct Acompanhamento {
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point prazo = std::chrono::steady_clock::time_point::max();
+    // (tempo desde o início em ms, objetivo, avaliações do solver) -> false interrompe a execução
+    std::function<bool(double, long long, long long)> progresso;
+    std::atomic<bool> cancelado{false};
+    std::mutex mtx;
+    long long ultimoAvisado = LLONG_MIN;
+
+    bool esgotado() const {
+        return cancelado.load(std::memory_order_relaxed) || std::chrono::steady_clock::now() >= prazo;
+    }
+
+    void notificar(long long objetivo, long long avaliacoes) {
+        if (!progresso) return;
+        std::lock_guard<std::mutex> lock(mtx);
+        if (objetivo <= ultimoAvisado || cancelado.load(std::memory_order_relaxed)) return;
+        ultimoAvisado = objetivo;
+        double tempoMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count();
+        if (!progresso(tempoMs, objetivo, avaliacoes)) cancelado.store(true, std::memory_order_relaxed);
+    }
+};
+
+// Acompanhamento das execuções de solver na thread chamadora (nullptr = nenhum). Como a semente,
+// é lido uma vez por cada solver ao iniciar (RegistroExecucao e Cooperacao).
+thread_local Acompanhamento* acompanhamentoAtual = nullptr;
+
+/**
+ * @brief Métricas de uma execução de solver: semente, avaliações e trajetória do incumbente.
+ *
+ * O contador de avaliações é atômico (qualquer thread da equipe pode somar); melhoria() deve
+ * ser chamada em trecho serial ('single' ou 'critical'). Os tempos contam desde a criação.
+ */
+struct RegistroExecucao {
+    unsigned semente;
+    std::chrono::steady_clock::time_point inicio;
+    double deslocamentoMs = 0.0;      // Tempo já decorrido antes de uma retomada de checkpoint
+    std::atomic<long long> avaliacoes{0};
+    std::vector<PontoTrajetoria> trajetoria;
+    Acompanhamento* acompanhamento = acompanhamentoAtual;
+
+    RegistroExecucao() : semente(sementeExecucao()), inicio(std::chrono::steady_clock::now()) {}
+
+    void contar(long long n) { avaliacoes.fetch_add(n, std::memory_order_relaxed); }
+
+    double decorridoMs() const {
+        return deslocamentoMs + std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count();
+    }
+
+    // Registra um novo incumbente (ignorado se não superar o último registrado).
+    void melhoria(long long objetivo) {
+        if (!trajetoria.empty() && objetivo <= trajetoria.back().objetivo) return;
+        trajetoria.push_back({decorridoMs(), objetivo, avaliacoes.load(std::memory_order_relaxed)});
+        if (acompanhamento) acompanhamento->notificar(objetivo, trajetoria.back().avaliacoes);
+    }
+
+    // Copia as métricas para o resultado final do solver.
+    void preencher(Resultado& res) const {
+        res.semente = semente;
+        res.avaliacoes = avaliacoes.load(std::memory_order_relaxed);
+        res.tempoAteMelhorMs = trajetoria.empty() ? 0.0 : trajetoria.back().tempoMs;
+        res.trajetoria = trajetoria;
+    }
+};
@@ -0,0 +1,118 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+#include "structs.hpp"
+#include "interpreter.hpp"
+
+// Renumeração dos itens para localidade de memória: itens que compartilham conjuntos de
+// penalidade passam a ter IDs próximos, de modo que a varredura de um conjunto (lucros, pesos,
+// bits da solução, contagens) toque poucas linhas de cache e poucas palavras do vetor de bits.
+// A ordem é a Cuthill-McKee reversa (RCM) sobre o grafo bipartido item-conjunto.
+
+struct Renumeracao {
+    std::vector<int> novoDeOriginal;   // novoDeOriginal[j] = novo ID do item original j
+    std::vector<int> originalDeNovo;   // originalDeNovo[k] = item original que recebeu o ID k
+};
+
+/**
+ * @brief Ordem RCM dos itens. Cada componente começa pelo item de menor grau (número de
+ *        conjuntos) ainda não visitado; a busca em largura expande cada conjunto uma única vez,
+ *        enfileirando seus itens não visitados em ordem crescente de grau. Custo
+ *        O(n + Σ|conjunto| log) e memória O(n + numSets).
+ * @return originalDeNovo: a sequência de itens originais na nova numeração.
+ */
+std::vector<int> ordemRCM(const Instance& inst) {
+    const int n = inst.numItems;
+    auto grau = [&](int j) { return inst.inicioConjuntosItem[j + 1] - inst.inicioConjuntosItem[j]; };
+
+    std::vector<int> porGrau(n);
+    for (int j = 0; j < n; ++j) porGrau[j] = j;
+    std::stable_sort(porGrau.begin(), porGrau.end(), [&](int a, int b) { return grau(a) < grau(b); });
+
+    std::vector<int> ordem;
+    ordem.reserve(n);
+    std::vector<unsigned char> itemVisitado(n, 0), conjuntoVisitado(inst.numSets, 0);
+    std::vector<int> vizinhos;
+    for (int raiz : porGrau) {
+        if (itemVisitado[raiz]) continue;
+        itemVisitado[raiz] = 1;
+        size_t frente = ordem.size();
+        ordem.push_back(raiz);
+        while (frente < ordem.size()) {
+            int j = ordem[frente++];
+            for (int p = inst.inicioConjuntosItem[j]; p < inst.inicioConjuntosItem[j + 1]; ++p) {
+                int s = inst.conjuntosDoItem[p];
+                if (conjuntoVisitado[s]) continue;
+                conjuntoVisitado[s] = 1;
+                vizinhos.clear();
+                for (int k : inst.forfeitSets[s].items) {
+                    if (itemVisitado[k]) continue;
+                    itemVisitado[k] = 1;
+                    vizinhos.push_back(k);
+                }
+                std::stable_sort(vizinhos.begin(), vizinhos.end(), [&](int a, int b) { return grau(a) < grau(b); });
+                ordem.insert(ordem.end(), vizinhos.begin(), vizinhos.end());
+            }
+        }
+    }
+    std::reverse(ordem.begin(), ordem.end());
+    return ordem;
+}
+
+// Dispersão média dos conjuntos: Σ(maior ID - menor ID + 1) / Σ|conjunto| (1 = todos contíguos).
+double dispersaoConjuntos(const Instance& inst) {
+    long long extensao = 0, membros = 0;
+    for (const auto& fs : inst.forfeitSets) {
+        if (fs.items.empty()) continue;
+        auto [menor, maior] = std::minmax_element(fs.items.begin(), fs.items.end());
+        extensao += *maior - *menor + 1;
+        membros += fs.items.size();
+    }
+    return membros ? double(extensao) / membros : 1.0;
+}
+
+/**
+ * @brief Reescreve a instância na ordem dada: lucros, pesos, itens de cada conjunto (em ordem
+ *        crescente do novo ID) e o índice item->conjuntos.
+ * @param originalDeNovo Permutação dos itens: originalDeNovo[k] recebe o ID k.
+ * @return O mapeamento entre as numerações, para traduzir soluções de volta (restaurarNumeracao).
+ */
+Renumeracao permutarItens(Instance& inst, const std::vector<int>& originalDeNovo) {
+    Renumeracao r;
+    r.originalDeNovo = originalDeNovo;
+    r.novoDeOriginal.assign(inst.numItems, 0);
+    for (int k = 0; k < inst.numItems; ++k) r.novoDeOriginal[r.originalDeNovo[k]] = k;
+
+    std::vector<int> profits(inst.numItems), weights(inst.numItems);
+    for (int k = 0; k < inst.numItems; ++k) {
+        profits[k] = inst.profits[r.originalDeNovo[k]];
+        weights[k] = inst.weights[r.originalDeNovo[k]];
+    }
+    inst.profits.swap(profits);
+    inst.weights.swap(weights);
+    for (auto& fs : inst.forfeitSets) {
+        for (int& item : fs.items) item = r.novoDeOriginal[item];
+        std::sort(fs.items.begin(), fs.items.end());
+    }
+    indexarConjuntos(inst);
+    return r;
+}
+
+// Renumeração na ordem RCM (ver ordemRCM).
+Renumeracao renumerarItens(Instance& inst) {
+    return permutarItens(inst, ordemRCM(inst));
+}
+
+// Solução na numeração original do arquivo.
+std::vector<bool> solucaoOriginal(const Renumeracao& r, const std::vector<bool>& sol) {
+    std::vector<bool> original(sol.size(), false);
+    for (size_t k = 0; k < sol.size(); ++k) {
+        if (sol[k]) original[r.originalDeNovo[k]] = true;
+    }
+    return original;
+}
+
+// Traduz os itens selecionados de um resultado para a numeração original (as métricas não mudam).
+void restaurarNumeracao(Resultado& res, const Renumeracao& r) {
+    res.itensSelecionados = solucaoOriginal(r, res.itensSelecionados);
+}
@@ -0,0 +1,285 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "structs.hpp"
+#include "parametros.hpp"
+
+// Seleção automática de solver ("auto"): características baratas da instância, calculadas em
+// uma passada, e uma tabela de regras "condições -> algoritmo [parâmetros]". A tabela padrão
+// está abaixo; main_b.out --gerar-regras a regenera a partir de execuções do benchmark.
+
+enum IndiceCaracteristica {
+    CAR_N = 0,            // Número de itens
+    CAR_CONJUNTOS,        // Número de conjuntos
+    CAR_FOLGA,            // Capacidade / soma dos pesos (1 = cabe tudo)
+    CAR_DENSIDADE,        // Conjuntos por item (Σ|conjunto| / n)
+    CAR_TAMANHO,          // Tamanho médio dos conjuntos
+    CAR_CORRELACAO,       // Correlação de Pearson entre lucro e peso
+    CAR_PERMITIDOS,       // Fração média de itens permitidos por conjunto (nA / |conjunto|)
+    CAR_CUSTO_RELATIVO,   // Custo médio de penalidade / lucro médio
+    NUM_CARACTERISTICAS
+};
+
+const char* const NOMES_CARACTERISTICAS[NUM_CARACTERISTICAS] = {
+    "n", "conjuntos", "folga", "densidade", "tamanho_conjunto", "correlacao", "permitidos", "custo_relativo"};
+
+using Caracteristicas = std::array<double, NUM_CARACTERISTICAS>;
+
+// Uma passada pelos itens e uma pelos conjuntos: O(n + numSets).
+Caracteristicas extrairCaracteristicas(const Instance& inst) {
+    Caracteristicas c{};
+    const double n = std::max(inst.numItems, 1);
+    double somaP = 0, somaW = 0, somaPP = 0, somaWW = 0, somaPW = 0;
+    for (int j = 0; j < inst.numItems; ++j) {
+        double p = inst.profits[j], w = inst.weights[j];
+        somaP += p;
+        somaW += w;
+        somaPP += p * p;
+        somaWW += w * w;
+        somaPW += p * w;
+    }
+    double membros = 0, permitidos = 0, custo = 0;
+    int naoVazios = 0;
+    for (const auto& fs : inst.forfeitSets) {
+        membros += fs.items.size();
+        custo += fs.forfeitCost;
+        if (!fs.items.empty()) {
+            permitidos += std::min(1.0, double(fs.nA) / fs.items.size());
+            naoVazios++;
+        }
+    }
+    double covariancia = somaPW / n - (somaP / n) * (somaW / n);
+    double varP = somaPP / n - (somaP / n) * (somaP / n), varW = somaWW / n - (somaW / n) * (somaW / n);
+
+    c[CAR_N] = inst.numItems;
+    c[CAR_CONJUNTOS] = inst.numSets;
+    c[CAR_FOLGA] = somaW > 0 ? std::min(1.0, inst.capacity / somaW) : 1.0;
+    c[CAR_DENSIDADE] = membros / n;
+    c[CAR_TAMANHO] = inst.numSets ? membros / inst.numSets : 0.0;
+    c[CAR_CORRELACAO] = varP > 0 && varW > 0 ? covariancia / std::sqrt(varP * varW) : 0.0;
+    c[CAR_PERMITIDOS] = naoVazios ? permitidos / naoVazios : 1.0;
+    c[CAR_CUSTO_RELATIVO] = inst.numSets && somaP > 0 ? (custo / inst.numSets) / (somaP / n) : 0.0;
+    return c;
+}
+
+struct CondicaoRegra {
+    int caracteristica;
+    bool menorIgual;    // true: valor <= limite; false: valor > limite
+    double limite;
+};
+
+struct RegraAuto {
+    std::vector<CondicaoRegra> condicoes;   // Todas precisam valer (vazio = regra padrão)
+    std::string algoritmo;
+    std::vector<std::pair<std::string, double>> parametros;   // "algoritmo.nome" = valor
+};
+
+bool regraAtende(const RegraAuto& r, const Caracteristicas& c) {
+    for (const auto& cond : r.condicoes) {
+        double v = c[cond.caracteristica];
+        if (cond.menorIgual ? !(v <= cond.limite) : !(v > cond.limite)) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Lê regras no formato de texto (uma por linha, '#' comenta):
+ *        "n<=1000 correlacao>0.5 -> vns vns.k_max=20". Vale a primeira regra que atender.
+ */
+std::vector<RegraAuto> lerRegras(std::istream& in, const std::string& origem) {
+    std::vector<RegraAuto> regras;
+    std::string linha;
+    int numLinha = 0;
+    while (std::getline(in, linha)) {
+        numLinha++;
+        size_t comentario = linha.find('#');
+        if (comentario != std::string::npos) linha.erase(comentario);
+        std::stringstream ss(linha);
+        std::string token;
+        RegraAuto r;
+        bool consequente = false;
+        while (ss >> token) {
+            auto erro = [&](const std::string& msg) {
+                return std::runtime_error(origem + ":" + std::to_string(numLinha) + ": " + msg + " '" + token + "'");
+            };
+            if (token == "->") {
+                consequente = true;
+            } else if (!consequente) {
+                bool menorIgual = token.find("<=") != std::string::npos;
+                size_t op = menorIgual ? token.find("<=") : token.find('>');
+                if (op == std::string::npos) throw erro("condicao invalida");
+                std::string nome = token.substr(0, op);
+                auto it = std::find(NOMES_CARACTERISTICAS, NOMES_CARACTERISTICAS + NUM_CARACTERISTICAS, nome);
+                if (it == NOMES_CARACTERISTICAS + NUM_CARACTERISTICAS) throw erro("caracteristica desconhecida");
+                r.condicoes.push_back({int(it - NOMES_CARACTERISTICAS), menorIgual, std::stod(token.substr(op + (menorIgual ? 2 : 1)))});
+            } else if (r.algoritmo.empty()) {
+                r.algoritmo = token;
+            } else {
+                size_t igual = token.find('=');
+                if (igual == std::string::npos) throw erro("parametro invalido");
+                r.parametros.push_back({token.substr(0, igual), std::stod(token.substr(igual + 1))});
+            }
+        }
+        if (!consequente && r.condicoes.empty()) continue;   // Linha vazia
+        if (r.algoritmo.empty()) throw std::runtime_error(origem + ":" + std::to_string(numLinha) + ": regra sem algoritmo");
+        regras.push_back(r);
+    }
+    return regras;
+}
+
+std::vector<RegraAuto> carregarRegras(const std::filesystem::path& caminho) {
+    std::ifstream arq(caminho);
+    if (!arq.is_open()) throw std::runtime_error("Erro ao abrir o arquivo de regras: " + caminho.string());
+    return lerRegras(arq, caminho.string());
+}
+
+void salvarRegras(const std::filesystem::path& caminho, const std::vector<RegraAuto>& regras, const std::string& cabecalho) {
+    if (caminho.has_parent_path()) std::filesystem::create_directories(caminho.parent_path());
+    std::ofstream out(caminho);
+    if (!out.is_open()) throw std::runtime_error("Erro ao gravar o arquivo de regras: " + caminho.string());
+    out << cabecalho;
+    for (const auto& r : regras) {
+        for (const auto& cond : r.condicoes) {
+            out << NOMES_CARACTERISTICAS[cond.caracteristica] << (cond.menorIgual ? "<=" : ">") << cond.limite << " ";
+        }
+        out << "-> " << r.algoritmo;
+        for (const auto& [nome, valor] : r.parametros) out << " " << nome << "=" << valor;
+        out << "\n";
+    }
+}
+
+// Tabela padrão, no mesmo formato dos arquivos de regras, tirada de main_b.out com repetições
+// nas instâncias de 30 a 300 itens (GRASP com o menor gap; o custo de tempo ainda não o supera)
+// e na de 10^6 itens, onde só a têmpera com varreduras limitadas termina em segundos.
+const char* const REGRAS_PADRAO =
+    "n>100000 -> tempera tempera.max_varreduras=100\n"
+    "-> grasp\n";
+
+// Regras do "auto" para a thread chamadora (vazio = REGRAS_PADRAO), como a semente e o checkpoint.
+thread_local std::vector<RegraAuto> regrasAutoDefinidas;
+
+void definirRegrasAuto(const std::vector<RegraAuto>& regras) {
+    regrasAutoDefinidas = regras;
+}
+
+struct EscolhaAuto {
+    std::string algoritmo;
+    Parametros parametros;      // 'params' do chamador com os ajustes da regra
+    int regra;                  // Índice da regra aplicada (-1 = nenhuma atendeu)
+    Caracteristicas caracteristicas;
+};
+
+EscolhaAuto escolherSolver(const Instance& inst, const Parametros& params) {
+    static const std::vector<RegraAuto> padrao = [] {
+        std::stringstream ss(REGRAS_PADRAO);
+        return lerRegras(ss, "REGRAS_PADRAO");
+    }();
+    const std::vector<RegraAuto>& regras = regrasAutoDefinidas.empty() ? padrao : regrasAutoDefinidas;
+
+    EscolhaAuto e{"grasp", params, -1, extrairCaracteristicas(inst)};
+    for (size_t k = 0; k < regras.size(); ++k) {
+        if (!regraAtende(regras[k], e.caracteristicas)) continue;
+        e.algoritmo = regras[k].algoritmo;
+        e.regra = k;
+        for (const auto& [nome, valor] : regras[k].parametros) {
+            if (e.parametros.find(nome) == e.parametros.end()) throw std::runtime_error("Parametro desconhecido na regra: " + nome);
+            e.parametros[nome] = valor;
+        }
+        break;
+    }
+    return e;
+}
+
+// ---------------------------------------------------------------------------------------
+// Geração das regras: árvore de decisão rasa que minimiza o custo total da escolha
+// ---------------------------------------------------------------------------------------
+
+// Uma instância do benchmark: características e custo de cada algoritmo executado nela.
+struct AmostraSelecao {
+    Caracteristicas caracteristicas;
+    std::map<std::string, double> custo;
+};
+
+// Algoritmo de menor custo total entre os que rodaram em todas as amostras do grupo.
+std::pair<std::string, double> melhorEscolha(const std::vector<AmostraSelecao>& amostras, const std::vector<int>& grupo) {
+    std::pair<std::string, double> melhor{"", 1e300};
+    for (const auto& [algoritmo, _] : amostras[grupo[0]].custo) {
+        double total = 0;
+        bool emTodas = true;
+        for (int i : grupo) {
+            auto it = amostras[i].custo.find(algoritmo);
+            if (it == amostras[i].custo.end()) {
+                emTodas = false;
+                break;
+            }
+            total += it->second;
+        }
+        if (emTodas && total < melhor.second) melhor = {algoritmo, total};
+    }
+    return melhor;
+}
+
+void dividirNo(const std::vector<AmostraSelecao>& amostras, const std::vector<int>& grupo, int profundidade,
+               int minFolha, std::vector<CondicaoRegra>& caminho, std::vector<RegraAuto>& regras) {
+    auto folha = melhorEscolha(amostras, grupo);
+
+    // Melhor corte: característica e limiar (ponto médio entre valores distintos) que mais reduz o custo
+    double melhorCusto = folha.second - 1e-9;
+    int melhorCar = -1;
+    double melhorLimite = 0;
+    if (profundidade > 0 && (int)grupo.size() >= 2 * minFolha) {
+        for (int car = 0; car < NUM_CARACTERISTICAS; ++car) {
+            std::vector<int> ordem = grupo;
+            std::sort(ordem.begin(), ordem.end(), [&](int a, int b) {
+                return amostras[a].caracteristicas[car] < amostras[b].caracteristicas[car];
+            });
+            for (int k = minFolha; k + minFolha <= (int)ordem.size(); ++k) {
+                double antes = amostras[ordem[k - 1]].caracteristicas[car], depois = amostras[ordem[k]].caracteristicas[car];
+                if (antes == depois) continue;
+                std::vector<int> esq(ordem.begin(), ordem.begin() + k), dir(ordem.begin() + k, ordem.end());
+                double custo = melhorEscolha(amostras, esq).second + melhorEscolha(amostras, dir).second;
+                if (custo < melhorCusto) {
+                    melhorCusto = custo;
+                    melhorCar = car;
+                    melhorLimite = (antes + depois) / 2;
+                }
+            }
+        }
+    }
+
+    if (melhorCar == -1) {
+        if (!folha.first.empty()) regras.push_back({caminho, folha.first, {}});
+        return;
+    }
+    std::vector<int> esq, dir;
+    for (int i : grupo) (amostras[i].caracteristicas[melhorCar] <= melhorLimite ? esq : dir).push_back(i);
+    caminho.push_back({melhorCar, true, melhorLimite});
+    dividirNo(amostras, esq, profundidade - 1, minFolha, caminho, regras);
+    caminho.back().menorIgual = false;
+    dividirNo(amostras, dir, profundidade - 1, minFolha, caminho, regras);
+    caminho.pop_back();
+}
+
+/**
+ * @brief Gera uma tabela de regras a partir de amostras do benchmark: árvore de decisão com até
+ *        'profundidade' cortes por caminho e ao menos 'minFolha' instâncias por folha; cada folha
+ *        escolhe o algoritmo de menor custo somado. Termina com uma regra padrão (melhor global).
+ */
+std::vector<RegraAuto> gerarRegras(const std::vector<AmostraSelecao>& amostras, int profundidade = 3, int minFolha = 2) {
+    std::vector<RegraAuto> regras;
+    if (amostras.empty()) return regras;
+    std::vector<int> todas(amostras.size());
+    for (size_t i = 0; i < amostras.size(); ++i) todas[i] = i;
+    std::vector<CondicaoRegra> caminho;
+    dividirNo(amostras, todas, profundidade, std::max(1, minFolha), caminho, regras);
+    if (regras.empty() || !regras.back().condicoes.empty()) regras.push_back({{}, melhorEscolha(amostras, todas).first, {}});
+    return regras;
+}
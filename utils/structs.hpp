@@ -1,26 +1,52 @@
 #pragma once
+#include <vector>
 
 struct ForfeitSet {
     int nA;                     // Número de itens "permitidos"
-    int forfeitCost;           // Penalidade caso exceda nA
+    int forfeitCost;           // Penalidade por item que exceda nA
     std::vector<int> items;    // IDs dos itens nesse conjunto
 };
 
 struct Instance {
     int numItems;
     int numSets;
-    int capacity;
+    long long capacity;
 
     std::vector<int> profits;
     std::vector<int> weights;
     std::vector<ForfeitSet> forfeitSets;
+
+    // Índice item -> conjuntos em formato CSR, preenchido por indexarConjuntos():
+    // os conjuntos do item j são conjuntosDoItem[inicioConjuntosItem[j] .. inicioConjuntosItem[j + 1]).
+    std::vector<int> inicioConjuntosItem;
+    std::vector<int> conjuntosDoItem;
+};
+
+// Ponto da trajetória do incumbente: instante, valor e avaliações feitas até a melhoria.
+struct PontoTrajetoria {
+    double tempoMs;
+    long long objetivo;
+    long long avaliacoes;
 };
 
 struct Resultado {
     std::vector<bool> itensSelecionados;
-    int lucroTotal;
-    int pesoTotal;
-    int penalidadeTotal;
-    int valorObjetivo;
+    long long lucroTotal;
+    long long pesoTotal;
+    long long penalidadeTotal;
+    long long valorObjetivo;
     double tempoMs;
+
+    // Métricas da execução, preenchidas pelos solvers (ver utils/registro.hpp)
+    unsigned semente = 0;
+    long long avaliacoes = 0;
+    double tempoAteMelhorMs = 0.0;
+    std::vector<PontoTrajetoria> trajetoria;
+
+    // Solvers exatos (algorithms/BB.cpp): prova de otimalidade ou gap final, e vazão de nós
+    bool otimoProvado = false;
+    double limiteSuperior = 0.0;
+    double gap = -1.0;            // (limiteSuperior - objetivo) / |limiteSuperior|; -1 = sem limite
+    long long nos = 0;
+    double nosPorSegundo = 0.0;
 };
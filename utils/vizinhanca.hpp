@@ -0,0 +1,179 @@
+#pragma once
+#include <vector>
+#include <climits>
+#include <cstdlib>
+#include <limits>
+#include <algorithm>
+#include "structs.hpp"
+#include "estado.hpp"
+
+// Melhor movimento 1-flip de uma varredura (item = -1 se nenhum vizinho é admissível).
+struct MelhorMovimento {
+    int item = -1;
+    long long delta = LLONG_MIN;
+};
+
+// Mantém 'a' com o melhor dos dois; empates vão para o menor índice (como na varredura serial).
+void combinarMovimento(MelhorMovimento& a, const MelhorMovimento& b) {
+    if (b.item == -1) return;
+    if (a.item == -1 || b.delta > a.delta || (b.delta == a.delta && b.item < a.item)) a = b;
+}
+
+// Satura um valor de 64 bits no intervalo do tipo T das faixas do kernel (identidade para 64 bits).
+template <typename T>
+T saturar(long long v) {
+    return static_cast<T>(std::max<long long>(std::numeric_limits<T>::min(),
+                                              std::min<long long>(std::numeric_limits<T>::max(), v)));
+}
+
+/**
+ * @brief Kernel de avaliação da vizinhança 1-flip completa em uma passada.
+ *
+ * Trabalha sobre arrays SoA (lucros e pesos da instância, nA e custos dos conjuntos), o que
+ * permite vetorizar já no SSE2. A cada passo:
+ *  1. prepararConjuntos(): custo de adicionar/remover um item de cada conjunto, O(numSets);
+ *  2. avaliarFaixa(): penalidade de cada flip pela soma sobre os conjuntos do item (índice CSR)
+ *     e, num laço SIMD sem desvios, delta de lucro/peso, máscaras de viabilidade e de
+ *     tabu/aspiração e argmax.
+ * Um passo completo custa O(n + Σ|conjunto|), contra O(n²) de copiar e recalcular cada vizinho.
+ *
+ * O laço usa faixas de 32 bits quando maior |lucro| + maior penalidade de um flip (soma dos
+ * custos dos conjuntos do item) cabe em int; senão, faixas de 64 bits. Em ambos os casos o
+ * delta é exato e nunca chega à marca de inadmissível. Folga e limiar de aspiração são
+ * saturados no tipo da faixa, o que preserva as comparações. As faixas são independentes:
+ * threads distintas podem avaliar faixas disjuntas.
+ */
+struct KernelVizinhanca {
+    std::vector<int> nA, custo;                // SoA dos conjuntos
+    std::vector<int> custoAdicao;              // Por conjunto: penalidade ao adicionar um item
+    std::vector<int> custoRemocao;             // Por conjunto: penalidade ao remover um item (<= 0)
+    std::vector<int> deltaPenalidade;          // Por item (faixas de 32 bits)
+    std::vector<int> delta;                    // Por item: delta do objetivo, INT_MIN se inadmissível
+    std::vector<long long> deltaPenalidadeLargo, deltaLargo;   // Idem, faixas de 64 bits
+    std::vector<unsigned char> viavel;         // Máscara: flip respeita a capacidade
+    std::vector<unsigned char> permitido;      // Máscara: não tabu ou aspirado
+    std::vector<int> semTabu;                  // Lista tabu vazia, para buscas sem tabu
+    bool largo = false;                        // Faixas de 64 bits
+
+    explicit KernelVizinhanca(const Instance& inst)
+        : nA(inst.numSets), custo(inst.numSets),
+          custoAdicao(inst.numSets), custoRemocao(inst.numSets),
+          viavel(inst.numItems), permitido(inst.numItems), semTabu(inst.numItems, 0) {
+        for (int s = 0; s < inst.numSets; ++s) {
+            nA[s] = inst.forfeitSets[s].nA;
+            custo[s] = inst.forfeitSets[s].forfeitCost;
+        }
+        long long maiorLucro = 0, maiorPenalidade = 0;
+        for (int p : inst.profits) maiorLucro = std::max(maiorLucro, std::llabs(p));
+        if (inst.numSets > 0) {
+            for (int j = 0; j < inst.numItems; ++j) {
+                long long pen = 0;
+                for (int p = inst.inicioConjuntosItem[j]; p < inst.inicioConjuntosItem[j + 1]; ++p) {
+                    pen += std::llabs(custo[inst.conjuntosDoItem[p]]);
+                }
+                maiorPenalidade = std::max(maiorPenalidade, pen);
+            }
+        }
+        largo = maiorLucro + maiorPenalidade > INT_MAX;
+        if (largo) {
+            deltaPenalidadeLargo.resize(inst.numItems);
+            deltaLargo.resize(inst.numItems);
+        } else {
+            deltaPenalidade.resize(inst.numItems);
+            delta.resize(inst.numItems);
+        }
+    }
+
+    // Penalidade do flip do item j calculada na última avaliação da sua faixa.
+    long long penalidadeFlip(int j) const {
+        return largo ? deltaPenalidadeLargo[j] : deltaPenalidade[j];
+    }
+};
+
+// Passo 1: custos marginais por conjunto a partir das contagens do estado.
+void prepararConjuntos(KernelVizinhanca& k, const EstadoSolucao& e) {
+    const int numSets = k.nA.size();
+    const int* cont = e.contagem.data();
+    const int* nA = k.nA.data();
+    const int* custo = k.custo.data();
+    int* adicao = k.custoAdicao.data();
+    int* remocao = k.custoRemocao.data();
+
+    #pragma omp simd
+    for (int s = 0; s < numSets; ++s) {
+        adicao[s] = -(cont[s] >= nA[s]) & custo[s];
+        remocao[s] = -(-(cont[s] > nA[s]) & custo[s]);
+    }
+}
+
+// Passo 2 sobre faixas do tipo T (int ou long long); 'pen' e 'delta' são os arrays dessa largura.
+template <typename T>
+MelhorMovimento varrerFaixa(KernelVizinhanca& k, const Instance& inst, const EstadoSolucao& e, T* pen, T* delta,
+                            int inicio, int fim, const int* tabu, int iter, long long aspiracao) {
+    // Penalidade de cada flip: soma sobre os conjuntos do item (gather no índice CSR)
+    const int* offs = inst.inicioConjuntosItem.data();
+    const int* conj = inst.conjuntosDoItem.data();
+    for (int j = inicio; j < fim; ++j) {
+        const int* custos = e.x[j] ? k.custoRemocao.data() : k.custoAdicao.data();
+        T soma = 0;
+        for (int p = offs[j]; p < offs[j + 1]; ++p) soma += custos[conj[p]];
+        pen[j] = soma;
+    }
+
+    const unsigned char* x = e.x.data();
+    const int* lucro = inst.profits.data();
+    const int* peso = inst.weights.data();
+    unsigned char* viavel = k.viavel.data();
+    unsigned char* permitido = k.permitido.data();
+    const T inadmissivel = std::numeric_limits<T>::min();
+    const T folga = saturar<T>(inst.capacity - e.peso);
+    // obj + d > aspiracao  <=>  d > limiar (saturado para não estourar com LLONG_MAX)
+    const T limiarAspiracao = aspiracao == LLONG_MAX ? std::numeric_limits<T>::max() : saturar<T>(aspiracao - e.objetivo());
+
+    T melhor = inadmissivel;
+    #pragma omp simd reduction(max:melhor)
+    for (int j = inicio; j < fim; ++j) {
+        T m = -static_cast<T>(x[j]);                          // 0 = adiciona, -1 = remove
+        T d = ((static_cast<T>(lucro[j]) ^ m) - m) - pen[j];  // ±lucro - penalidade
+        T dw = (static_cast<T>(peso[j]) ^ m) - m;             // ±peso
+        T v = dw <= folga;
+        T a = (iter >= tabu[j]) | (d > limiarAspiracao);
+        viavel[j] = v;
+        permitido[j] = a;
+        T admissivel = -(v & a);
+        T pontuacao = (d & admissivel) | (inadmissivel & ~admissivel);
+        delta[j] = pontuacao;
+        melhor = pontuacao > melhor ? pontuacao : melhor;
+    }
+
+    MelhorMovimento mov;
+    if (melhor == inadmissivel) return mov;
+    for (int j = inicio; j < fim; ++j) {
+        if (delta[j] == melhor) {
+            mov.item = j;
+            mov.delta = melhor;
+            break;
+        }
+    }
+    return mov;
+}
+
+/**
+ * @brief Passo 2: avalia os flips dos itens em [inicio, fim) e devolve o melhor admissível.
+ * @param tabu Iteração até a qual cada item é tabu (use k.semTabu para desligar).
+ * @param iter Iteração corrente.
+ * @param aspiracao Um flip tabu é admitido se levar o objetivo acima deste valor.
+ */
+MelhorMovimento avaliarFaixa(KernelVizinhanca& k, const Instance& inst, const EstadoSolucao& e,
+                             int inicio, int fim, const int* tabu, int iter, long long aspiracao) {
+    if (k.largo) {
+        return varrerFaixa(k, inst, e, k.deltaPenalidadeLargo.data(), k.deltaLargo.data(), inicio, fim, tabu, iter, aspiracao);
+    }
+    return varrerFaixa(k, inst, e, k.deltaPenalidade.data(), k.delta.data(), inicio, fim, tabu, iter, aspiracao);
+}
+
+// Varredura completa (serial) da vizinhança, sem lista tabu.
+MelhorMovimento melhorFlip(KernelVizinhanca& k, const Instance& inst, const EstadoSolucao& e) {
+    prepararConjuntos(k, e);
+    return avaliarFaixa(k, inst, e, 0, inst.numItems, k.semTabu.data(), 0, LLONG_MAX);
+}